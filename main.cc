@@ -1,6 +1,8 @@
 //------------------------------------------------------------------------------
 //
 //------------------------------------------------------------------------------
+#include <stdint.h>
+
 #include <iostream>
 #include <limits>
 #include <stdexcept>
@@ -9,8 +11,10 @@
 
 #include "boost/program_options.hpp"
 
+#include "wartzaar/bench.h"
 #include "wartzaar/game_client.h"
 #include "wartzaar/messages/game_messages_common.h"
+#include "wartzaar/perft.h"
 #include "wartzaar/tzaar_game.h"
 
 namespace po = boost::program_options;
@@ -30,11 +34,30 @@ int main(int argc, char *argv[]) {
           "TCP/IP port on which the game manager is listening.")
 
       ("turn-time", po::value<int>()->default_value(20),
-          "Allowed time for each turn move, in seconds.")
+          "Allowed time for each turn move, in seconds. The first move of "
+          "a turn may take the time of both, as it plans the second.")
       ("search-depth", po::value<int>()->default_value((std::numeric_limits<int>::max)()),
           "Maximum depth of the minimax search.")
+      ("depth", po::value<int>(),
+          "Search every move to this depth, with no time limit. With one "
+          "thread, the search is the same on every run.")
+      ("nodes", po::value<uint64_t>(),
+          "Stop each search after this many nodes of the main thread, with "
+          "no time limit. With one thread, the search is the same on every "
+          "run.")
       ("beam-size", po::value<int>()->default_value((std::numeric_limits<int>::max)()),
           "Number of states to search at each ply.")
+      ("hash-mb", po::value<int>()->default_value(64),
+          "Size of the transposition table, in megabytes.")
+      ("qsearch-depth", po::value<int>()->default_value(2),
+          "Maximum number of captures searched past the search depth.")
+      ("threads", po::value<int>()->default_value(1),
+          "Number of search threads.")
+      ("parallel-search", po::value<std::string>()->default_value("lazy"),
+          "How the search threads share the work: lazy (lazy SMP) or ybw "
+          "(Young Brothers Wait).")
+      ("ponder", po::bool_switch(),
+          "Search the opponent's turn while waiting for their moves.")
 
       ("tzaar-coefficient", po::value<int>()->default_value(64),
           "Weight of tzaar pieces in heuristic evaluation.")
@@ -43,7 +66,15 @@ int main(int argc, char *argv[]) {
       ("tott-coefficient", po::value<int>()->default_value(1),
           "Weight of tott pieces in heuristic evaluation.")
       ("stack-coefficient", po::value<int>()->default_value(10),
-          "Factor to use to normalize stack height values.");
+          "Factor to use to normalize stack height values.")
+
+      ("bench", po::value<int>(),
+          "Search the benchmark positions to the given depth, then exit.")
+      ("perft", po::value<int>(),
+          "Count the move sequences to the given depth, then exit.")
+      ("board", po::value<std::string>(),
+          "BoardState message to run perft from, with white to move at the "
+          "start of a turn. Defaults to the standard opening.");
 
   po::variables_map vm;
   try {
@@ -75,9 +106,30 @@ int main(int argc, char *argv[]) {
   if (vm.count("search-depth"))
     std::cout << "Search depth: " << vm["search-depth"].as<int>() << std::endl;
 
+  if (vm.count("depth"))
+    std::cout << "Fixed depth: " << vm["depth"].as<int>() << std::endl;
+
+  if (vm.count("nodes"))
+    std::cout << "Node limit: " << vm["nodes"].as<uint64_t>() << std::endl;
+
   if (vm.count("beam-size"))
     std::cout << "Beam size: " << vm["beam-size"].as<int>() << std::endl;
 
+  if (vm.count("hash-mb"))
+    std::cout << "Hash size (MB): " << vm["hash-mb"].as<int>() << std::endl;
+
+  if (vm.count("qsearch-depth"))
+    std::cout << "Quiescence search depth: " << vm["qsearch-depth"].as<int>() << std::endl;
+
+  if (vm.count("threads"))
+    std::cout << "Search threads: " << vm["threads"].as<int>() << std::endl;
+
+  if (vm.count("parallel-search"))
+    std::cout << "Parallel search: " << vm["parallel-search"].as<std::string>() << std::endl;
+
+  if (vm.count("ponder"))
+    std::cout << "Ponder: " << (vm["ponder"].as<bool>() ? "on" : "off") << std::endl;
+
   if (vm.count("tzaar-coefficient"))
     std::cout << "Tzaar coefficient: " << vm["tzaar-coefficient"].as<int>() << std::endl;
 
@@ -90,6 +142,71 @@ int main(int argc, char *argv[]) {
   if (vm.count("stack-coefficient"))
     std::cout << "Stack coefficient: " << vm["stack-coefficient"].as<int>() << std::endl;
 
+  namespace wtps = wartzaar::types::parallelsearch;
+  wtps::ParallelSearch parallel_search = wtps::kLazySmp;
+  if (vm["parallel-search"].as<std::string>() == "ybw") {
+    parallel_search = wtps::kYoungBrothersWait;
+  }
+  else if (vm["parallel-search"].as<std::string>() != "lazy") {
+    std::cerr << "WarTzaar: invalid parallel search: "
+              << vm["parallel-search"].as<std::string>() << std::endl;
+    std::cout << desc << std::endl;
+    return 1;
+  }
+
+  //----------------------------------------------------------------------------
+  // Run the benchmark instead of playing, if asked to.
+  //----------------------------------------------------------------------------
+  if (vm.count("bench")) {
+    std::cout << "Bench depth: " << vm["bench"].as<int>() << std::endl;
+
+    try {
+      wartzaar::Bench(
+          vm["bench"].as<int>(),
+          vm["hash-mb"].as<int>(),
+          vm["qsearch-depth"].as<int>(),
+          vm["threads"].as<int>(),
+          vm["tzaar-coefficient"].as<int>(),
+          vm["tzarra-coefficient"].as<int>(),
+          vm["tott-coefficient"].as<int>(),
+          vm["stack-coefficient"].as<int>()
+      ).Run(std::cout);
+    }
+    catch (std::runtime_error &e) {
+      std::cerr << "Runtime error in bench: " << e.what() << std::endl;
+      return 1;
+    }
+
+    return 0;
+  }
+
+  //----------------------------------------------------------------------------
+  // Run perft instead of playing, if asked to.
+  //
+  // The standard opening starts with white's single capturing move. A given
+  // board starts with white's capturing move of an ordinary turn.
+  //----------------------------------------------------------------------------
+  if (vm.count("perft")) {
+    std::cout << "Perft depth: " << vm["perft"].as<int>() << std::endl;
+
+    try {
+      bool opening = vm.count("board") == 0;
+      std::string text = opening ? wartzaar::Perft::kStandardOpening
+                                 : vm["board"].as<std::string>();
+
+      wartzaar::GameState state(wm::BoardStateMessage(text).board_state());
+      state.SetTurn(wartzaar::types::color::kWhite, true, opening);
+
+      wartzaar::Perft(state).Run(vm["perft"].as<int>(), std::cout);
+    }
+    catch (std::runtime_error &e) {
+      std::cerr << "Runtime error in perft: " << e.what() << std::endl;
+      return 1;
+    }
+
+    return 0;
+  }
+
   //----------------------------------------------------------------------------
   // Create the game client and establish a connection with the game manager.
   //----------------------------------------------------------------------------
@@ -110,13 +227,23 @@ int main(int argc, char *argv[]) {
   //----------------------------------------------------------------------------
   wartzaar::TzaarGame tzaar_game(
       vm["turn-time"].as<int>(),
-      vm["search-depth"].as<int>(),
+      vm.count("depth") ? vm["depth"].as<int>() : vm["search-depth"].as<int>(),
       vm["beam-size"].as<int>(),
+      vm["hash-mb"].as<int>(),
+      vm["qsearch-depth"].as<int>(),
+      vm["threads"].as<int>(),
       vm["tzaar-coefficient"].as<int>(),
       vm["tzarra-coefficient"].as<int>(),
       vm["tott-coefficient"].as<int>(),
       vm["stack-coefficient"].as<int>()
   );
+  tzaar_game.set_parallel_search(parallel_search);
+  tzaar_game.set_ponder(vm["ponder"].as<bool>());
+
+  // A fixed depth or node limit replaces the clock
+  tzaar_game.set_timed(vm.count("depth") == 0 && vm.count("nodes") == 0);
+  if (vm.count("nodes"))
+    tzaar_game.set_node_limit(vm["nodes"].as<uint64_t>());
 
   //----------------------------------------------------------------------------
   // Enter the main program loop.
@@ -177,8 +304,11 @@ int main(int argc, char *argv[]) {
       //------------------------------------------------------------------------
       else if (text.substr(0, strlen("Move")) == "Move") {
         wm::MoveMessage message(text);
-        tzaar_game.MakeMove(message.from_column(), message.from_row(),
-                            message.to_column(), message.to_row());
+        if (message.pass())
+          tzaar_game.MakePass();
+        else
+          tzaar_game.MakeMove(message.from_column(), message.from_row(),
+                              message.to_column(), message.to_row());
 
         tzaar_game.set_turn_move_count(0);
 
@@ -0,0 +1,200 @@
+//------------------------------------------------------------------------------
+// Microbenchmarks of the board, move generation, evaluation and message
+// primitives, apart from any search.
+//
+// Each benchmark runs one primitive over every bench position, repeating it
+// until it has run for at least kMinTime, and reports the time and the heap
+// allocations of a single operation.
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "wartzaar/bench.h"
+#include "wartzaar/clock.h"
+#include "wartzaar/game_board.h"
+#include "wartzaar/game_state.h"
+#include "wartzaar/messages/board_state_message.h"
+#include "wartzaar/messages/move_message.h"
+#include "wartzaar/move.h"
+#include "wartzaar/move_generator.h"
+#include "wartzaar/tzaar_game.h"
+#include "wartzaar/types/color.h"
+#include "wartzaar/types/direction.h"
+
+namespace wm  = wartzaar::messages;
+namespace wtc = wartzaar::types::color;
+namespace wtd = wartzaar::types::direction;
+
+namespace {
+
+/// The number of heap allocations made so far, counted by operator new.
+uint64_t allocations = 0;
+
+/// The least time each benchmark runs for.
+const std::chrono::milliseconds kMinTime(500);
+
+/// Results are added to the sink so that the compiler can't drop the work.
+volatile uint64_t sink = 0;
+
+/// Runs op(), which performs the given number of operations, until kMinTime
+/// has passed, doubling the number of runs each time. Writes the time and
+/// allocations of one operation.
+template <typename Op>
+void Run(const char *name, int ops_per_run, Op op) {
+  uint64_t runs = 1;
+
+  for (;;) {
+    uint64_t allocations_start = allocations;
+    wartzaar::Clock::time_point start = wartzaar::Clock::now();
+
+    for (uint64_t i = 0; i < runs; ++i)
+      op();
+
+    wartzaar::Clock::duration elapsed = wartzaar::Clock::now() - start;
+
+    if (elapsed >= kMinTime) {
+      double ops = static_cast<double>(runs) * ops_per_run;
+      double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+
+      std::cout << std::left << std::setw(32) << name << std::right
+                << std::fixed << std::setprecision(1)
+                << std::setw(12) << ns / ops
+                << std::setprecision(2)
+                << std::setw(12) << (allocations - allocations_start) / ops
+                << std::setw(14) << static_cast<uint64_t>(ops)
+                << std::endl;
+      return;
+    }
+
+    runs *= 2;
+  }
+}
+
+} // namespace
+
+void* operator new(size_t size) {
+  ++allocations;
+
+  void *p = malloc(size > 0 ? size : 1);
+  if (p == nullptr)
+    throw std::bad_alloc();
+  return p;
+}
+
+void operator delete(void *p) throw() {
+  free(p);
+}
+
+int main() {
+  //----------------------------------------------------------------------------
+  // Set up the bench positions, with white to move, and the first move of
+  // each.
+  //----------------------------------------------------------------------------
+  const int positions = wartzaar::Bench::kNumPositions;
+
+  std::vector<std::string> texts;
+  std::vector<wartzaar::GameState> states;
+  std::vector<wartzaar::Move> moves;
+  for (int i = 0; i < positions; ++i) {
+    const wartzaar::Bench::Position &position = wartzaar::Bench::kPositions[i];
+
+    texts.push_back(position.board_state);
+    states.push_back(wartzaar::GameState(
+        wm::BoardStateMessage(texts.back()).board_state()));
+    states.back().SetTurn(wtc::kWhite, true, position.opening);
+
+    wartzaar::MoveList move_list;
+    wartzaar::MoveGenerator::GenerateMoves(states.back(), wtc::kWhite, true,
+        move_list);
+    moves.push_back(move_list[0]);
+  }
+
+  wartzaar::TzaarGame game(0, 1, 1, 1, 0, 1, 64, 8, 1, 10);
+  game.set_player_number("One");
+
+  std::vector<wartzaar::GameBoard> boards(positions);
+
+  std::cout << std::left << std::setw(32) << "Benchmark" << std::right
+            << std::setw(12) << "ns/op"
+            << std::setw(12) << "allocs/op"
+            << std::setw(14) << "ops" << std::endl;
+
+  //----------------------------------------------------------------------------
+  // Run the benchmarks.
+  //----------------------------------------------------------------------------
+  Run("GameBoard copy", positions, [&]() {
+    for (int i = 0; i < positions; ++i) {
+      wartzaar::GameBoard board(states[i].board());
+      sink += board.StackHeightAt(i);
+    }
+  });
+
+  Run("GameBoard assignment", positions, [&]() {
+    for (int i = 0; i < positions; ++i) {
+      boards[i] = states[i].board();
+      sink += boards[i].StackHeightAt(i);
+    }
+  });
+
+  Run("GameState make/unmake", positions, [&]() {
+    wartzaar::UndoRecord undo;
+    for (int i = 0; i < positions; ++i) {
+      states[i].MakeMove(moves[i], undo);
+      sink += states[i].hash();
+      states[i].UnmakeMove(undo);
+    }
+  });
+
+  Run("GameBoard::SearchPath",
+      positions * wartzaar::GameBoard::kNumCells * 6, [&]() {
+    for (int i = 0; i < positions; ++i) {
+      const wartzaar::GameBoard &board = states[i].board();
+      for (int cell = 0; cell < wartzaar::GameBoard::kNumCells; ++cell)
+        for (int dir = wtd::kNorth; dir <= wtd::kNorthwest; ++dir)
+          sink += board.SearchPath(cell, static_cast<wtd::Direction>(dir));
+    }
+  });
+
+  Run("MoveGenerator::GenerateMoves", positions, [&]() {
+    for (int i = 0; i < positions; ++i) {
+      wartzaar::MoveList move_list;
+      wartzaar::MoveGenerator::GenerateMoves(states[i], wtc::kWhite, false,
+          move_list);
+      sink += move_list.size();
+    }
+  });
+
+  Run("MoveGenerator::CountMoves", positions, [&]() {
+    for (int i = 0; i < positions; ++i)
+      sink += wartzaar::MoveGenerator::CountMoves(states[i], wtc::kWhite,
+          false);
+  });
+
+  Run("TzaarGame::Evaluate", positions, [&]() {
+    for (int i = 0; i < positions; ++i)
+      sink += static_cast<int>(game.Evaluate(states[i]));
+  });
+
+  Run("BoardStateMessage parse", positions, [&]() {
+    for (int i = 0; i < positions; ++i) {
+      wm::BoardStateMessage message(texts[i]);
+      sink += message.board_state().OccupiedMask();
+    }
+  });
+
+  Run("MoveMessage format", positions, [&]() {
+    for (int i = 0; i < positions; ++i) {
+      wm::MoveMessage message(moves[i]);
+      sink += message.text().size();
+    }
+  });
+
+  return 0;
+}
@@ -0,0 +1,508 @@
+#include "wartzaar/bench.h"
+
+#include <chrono>
+#include <iomanip>
+#include <limits>
+#include <ostream>
+
+#include "wartzaar/clock.h"
+#include "wartzaar/game_state.h"
+#include "wartzaar/messages/board_state_message.h"
+#include "wartzaar/messages/move_message.h"
+#include "wartzaar/perft.h"
+#include "wartzaar/tzaar_game.h"
+
+namespace wm = wartzaar::messages;
+
+namespace wartzaar {
+
+namespace {
+
+/// The FNV-1a offset basis and prime, which the signature is hashed with.
+const uint64_t kSignatureBasis = 14695981039346656037ULL;
+const uint64_t kSignaturePrime = 1099511628211ULL;
+
+/// Hashes the bytes of the given value into the signature.
+void HashInto(uint64_t &signature, uint64_t value) {
+  for (int i = 0; i < 8; ++i) {
+    signature ^= (value >> (8 * i)) & 0xff;
+    signature *= kSignaturePrime;
+  }
+}
+
+} // namespace
+
+/// The positions after the opening come from games played out from it, and
+/// are given with white to move. One stack per cell, in cell number order;
+/// only the top piece type of a stack is kept.
+const Bench::Position Bench::kPositions[] = {
+  { "opening", Perft::kStandardOpening, true },
+  { "early 1",
+      "BoardState{"
+      "{WHITE,Tott},{BLACK,Tott},{WHITE,Tott},{BLACK,Tott},{WHITE,Tott},"
+      "{BLACK,Tott},{WHITE,Tott},{BLACK,Tzarra},{WHITE,Tzarra},{BLACK,Tott},"
+      "{BLACK,Tott},{WHITE,Tott},{BLACK,Tzarra},{WHITE,Tzaar},{BLACK,Tzaar},"
+      "{WHITE,Tzarra},{WHITE,Tzarra},{WHITE,Tott},{BLACK,Tott},"
+      "{WHITE,Tzarra},{BLACK,Tzarra},{WHITE,Tzaar},{BLACK,Tzaar},"
+      "{BLACK,Tzarra},{BLACK,Tzarra},{BLACK,Tott},{WHITE,Tott},{BLACK,Tott},"
+      "{WHITE,Tzarra},{WHITE,Tzaar},{WHITE,Tzaar},{WHITE,Tzaar},{WHITE,Tott},"
+      "{WHITE,Tott},{BLACK,Tott},{BLACK,Tzarra},{BLACK,Tzaar},{},"
+      "{BLACK,Tzaar},{BLACK,Tzaar},{BLACK,Tzarra},{BLACK,Tott},{WHITE,Tott},"
+      "{},{WHITE,Tzaar},{BLACK,Tzarra},{BLACK,Tott},{WHITE,Tzarra},"
+      "{WHITE,Tott},{BLACK,Tott},{WHITE,Tott},{BLACK,Tzarra},{WHITE,Tzarra},"
+      "{},{BLACK,Tott},{WHITE,Tott},{BLACK,Tott},{WHITE,Tott},{BLACK,Tott},"
+      "{WHITE,Tott}"
+      "}",
+    false },
+  { "early 2",
+      "BoardState{"
+      "{WHITE,Tott},{BLACK,Tott},{WHITE,Tott},{BLACK,Tott},{WHITE,Tott},"
+      "{BLACK,Tott},{WHITE,Tott},{BLACK,Tzarra},{WHITE,Tzarra},{BLACK,Tott},"
+      "{BLACK,Tott},{WHITE,Tott},{BLACK,Tzarra},{WHITE,Tzaar},{BLACK,Tzaar},"
+      "{WHITE,Tzarra},{WHITE,Tzarra},{WHITE,Tott},{BLACK,Tott,Tott},"
+      "{WHITE,Tzarra},{BLACK,Tzarra},{WHITE,Tzaar},{BLACK,Tzaar},"
+      "{BLACK,Tzarra},{BLACK,Tzarra},{BLACK,Tott},{WHITE,Tott},{},"
+      "{WHITE,Tzarra},{WHITE,Tzaar},{WHITE,Tzaar},{WHITE,Tzaar},{WHITE,Tott},"
+      "{BLACK,Tott},{BLACK,Tott},{BLACK,Tzarra},{BLACK,Tzaar},{},"
+      "{BLACK,Tzaar},{BLACK,Tzaar},{BLACK,Tzarra},{},{WHITE,Tott},{},"
+      "{WHITE,Tzaar},{WHITE,Tzarra},{},{},{WHITE,Tott},{BLACK,Tott},"
+      "{WHITE,Tott},{BLACK,Tzarra},{WHITE,Tzarra},{},{BLACK,Tott},"
+      "{WHITE,Tott},{BLACK,Tott},{WHITE,Tott},{BLACK,Tott},{WHITE,Tott}"
+      "}",
+    false },
+  { "early 3",
+      "BoardState{"
+      "{WHITE,Tott},{BLACK,Tott},{WHITE,Tott},{BLACK,Tott},{WHITE,Tott},"
+      "{BLACK,Tott},{WHITE,Tott},{BLACK,Tzarra},{WHITE,Tzarra},{BLACK,Tott},"
+      "{BLACK,Tott},{WHITE,Tott},{BLACK,Tzarra},{WHITE,Tzaar},{BLACK,Tzaar},"
+      "{WHITE,Tzarra},{BLACK,Tzarra},{WHITE,Tott},{BLACK,Tott},"
+      "{WHITE,Tzarra},{BLACK,Tzarra},{WHITE,Tzaar},{BLACK,Tzaar},"
+      "{BLACK,Tzarra},{},{BLACK,Tott},{WHITE,Tott},{BLACK,Tott},"
+      "{WHITE,Tzarra},{BLACK,Tzaar},{WHITE,Tzaar},{WHITE,Tzaar},{WHITE,Tott},"
+      "{WHITE,Tott},{BLACK,Tott},{WHITE,Tzarra},{BLACK,Tzaar},{WHITE,Tzaar},"
+      "{BLACK,Tzaar},{BLACK,Tzaar},{BLACK,Tzarra},{BLACK,Tott},{WHITE,Tott},"
+      "{},{WHITE,Tzaar},{BLACK,Tzarra},{WHITE,Tzarra},{WHITE,Tzarra},"
+      "{WHITE,Tott},{BLACK,Tott},{BLACK,Tzarra},{BLACK,Tzarra},{},"
+      "{WHITE,Tzarra},{BLACK,Tott},{WHITE,Tott},{BLACK,Tott},{WHITE,Tott},"
+      "{BLACK,Tott},{WHITE,Tott}"
+      "}",
+    false },
+  { "midgame 1",
+      "BoardState{"
+      "{WHITE,Tott},{BLACK,Tott},{WHITE,Tott},{WHITE,Tzarra},{WHITE,Tott},"
+      "{BLACK,Tott},{WHITE,Tott},{BLACK,Tzarra},{},{BLACK,Tott},{BLACK,Tott},"
+      "{BLACK,Tott,Tott},{WHITE,Tzaar},{},{BLACK,Tzaar},{},{WHITE,Tzarra},"
+      "{WHITE,Tott},{},{WHITE,Tzarra},{BLACK,Tzarra},{WHITE,Tzaar},"
+      "{WHITE,Tzarra},{},{BLACK,Tzarra},{},{WHITE,Tott},{},{WHITE,Tzarra},"
+      "{WHITE,Tzaar},{},{WHITE,Tzaar},{WHITE,Tott},{BLACK,Tott,Tott,Tott},"
+      "{BLACK,Tott},{BLACK,Tzarra},{},{},{WHITE,Tzaar},{BLACK,Tzaar},{},{},"
+      "{WHITE,Tott},{},{BLACK,Tzaar},{},{},{},{},{BLACK,Tott},{WHITE,Tott},"
+      "{WHITE,Tzarra},{BLACK,Tott},{},{BLACK,Tott},{WHITE,Tott},{BLACK,Tott},"
+      "{WHITE,Tott},{},{WHITE,Tott}"
+      "}",
+    false },
+  { "midgame 2",
+      "BoardState{"
+      "{},{WHITE,Tott},{},{},{},{},{WHITE,Tott},{},{},{WHITE,Tzarra},"
+      "{WHITE,Tott},{WHITE,Tzarra,Tzarra},{BLACK,Tzarra},{WHITE,Tzaar},"
+      "{BLACK,Tzarra,Tzarra,Tzarra},{WHITE,Tzarra},{WHITE,Tott},{WHITE,Tott},"
+      "{BLACK,Tott},{},{BLACK,Tzarra},{BLACK,Tzaar},{},{BLACK,Tzarra},{},{},"
+      "{},{BLACK,Tott},{},{},{WHITE,Tzaar},{},{},{BLACK,Tott},"
+      "{WHITE,Tott,Tott},{},{},{BLACK,Tott,Tott},{},{},{BLACK,Tzaar},{},"
+      "{BLACK,Tzarra},{},{},{},{},{},{BLACK,Tott},{BLACK,Tott},"
+      "{BLACK,Tzarra},{WHITE,Tzarra,Tzarra},{},{},{},{WHITE,Tott},{},"
+      "{WHITE,Tzaar},{},{BLACK,Tzaar,Tzaar}"
+      "}",
+    false },
+  { "midgame 3",
+      "BoardState{"
+      "{WHITE,Tott},{BLACK,Tott},{},{},{WHITE,Tott},{WHITE,Tott},{},"
+      "{WHITE,Tzarra},{},{WHITE,Tzarra},{BLACK,Tott},{},{},{WHITE,Tzaar},{},"
+      "{WHITE,Tzarra},{},{BLACK,Tzarra},{WHITE,Tott},{WHITE,Tzarra},{},"
+      "{WHITE,Tott},{BLACK,Tzaar},{WHITE,Tzaar},{},{BLACK,Tott},{WHITE,Tott},"
+      "{BLACK,Tott},{WHITE,Tzarra},{BLACK,Tzarra,Tzarra,Tzarra},"
+      "{WHITE,Tzaar},{},{WHITE,Tott},{BLACK,Tzarra,Tzarra},{BLACK,Tott},"
+      "{WHITE,Tzarra},{BLACK,Tzaar},{},{BLACK,Tzaar},{BLACK,Tzaar},{},{},"
+      "{WHITE,Tott},{BLACK,Tzarra},{WHITE,Tzaar},{},{WHITE,Tzarra},"
+      "{BLACK,Tott},{WHITE,Tott},{},{BLACK,Tott},{WHITE,Tzaar},"
+      "{WHITE,Tzarra},{},{BLACK,Tott},{},{BLACK,Tott},{WHITE,Tott},{},"
+      "{BLACK,Tott}"
+      "}",
+    false },
+  { "midgame 4",
+      "BoardState{"
+      "{BLACK,Tott},{},{WHITE,Tott},{},{WHITE,Tott},{},{},{},"
+      "{WHITE,Tott,Tott},{},{BLACK,Tott,Tott},{},{},"
+      "{WHITE,Tzaar,Tzaar,Tzaar},{BLACK,Tzaar},{WHITE,Tzarra},{},"
+      "{WHITE,Tott},{},{},{},{},{BLACK,Tzaar},{BLACK,Tzarra},{},{BLACK,Tott},"
+      "{},{BLACK,Tzarra,Tzarra,Tzarra,Tzarra},{},{BLACK,Tzaar},{},"
+      "{WHITE,Tzaar},{BLACK,Tzarra},{WHITE,Tott},{},{},{},{},{},"
+      "{WHITE,Tzarra},{},{WHITE,Tott},{WHITE,Tott},{BLACK,Tzarra},{},"
+      "{WHITE,Tzaar},{},{WHITE,Tzarra},{},{BLACK,Tott},{},{},{},{BLACK,Tott},"
+      "{},{BLACK,Tzaar},{WHITE,Tott},{BLACK,Tott},{},{WHITE,Tott}"
+      "}",
+    false },
+  { "midgame 5",
+      "BoardState{"
+      "{WHITE,Tott},{BLACK,Tott},{},{BLACK,Tott},{WHITE,Tott},{BLACK,Tott},"
+      "{WHITE,Tott},{WHITE,Tott},{WHITE,Tzarra},{},{WHITE,Tott},{WHITE,Tott},"
+      "{},{WHITE,Tzaar},{BLACK,Tzaar},{BLACK,Tott},{WHITE,Tzarra},{},"
+      "{BLACK,Tott},{BLACK,Tzarra},{BLACK,Tzarra},{WHITE,Tzaar},"
+      "{BLACK,Tzarra,Tzarra,Tzarra},{},{},{BLACK,Tott},{WHITE,Tott},"
+      "{BLACK,Tott},{WHITE,Tzarra},{BLACK,Tzaar},{BLACK,Tzaar},{WHITE,Tzaar},"
+      "{WHITE,Tott},{WHITE,Tott},{WHITE,Tzarra,Tzarra},{},{BLACK,Tzaar},"
+      "{WHITE,Tzaar},{},{BLACK,Tzaar},{BLACK,Tzarra},{BLACK,Tott},{},"
+      "{BLACK,Tzarra},{WHITE,Tzaar},{BLACK,Tzarra},{WHITE,Tzarra},"
+      "{WHITE,Tzarra},{WHITE,Tott},{BLACK,Tott},{BLACK,Tzarra},{},"
+      "{WHITE,Tzarra},{BLACK,Tott},{BLACK,Tott},{WHITE,Tott},{BLACK,Tott},"
+      "{WHITE,Tott},{WHITE,Tott},{}"
+      "}",
+    false },
+  { "midgame 6",
+      "BoardState{"
+      "{BLACK,Tott},{},{},{},{BLACK,Tott},{BLACK,Tott},{WHITE,Tott},{},"
+      "{WHITE,Tzarra},{WHITE,Tzarra,Tzarra},{BLACK,Tott},{WHITE,Tott},"
+      "{BLACK,Tzarra},{},{WHITE,Tzaar},{},{},{WHITE,Tott},{BLACK,Tott},{},{},"
+      "{WHITE,Tzaar},{},{BLACK,Tzarra},{BLACK,Tzarra},{},{BLACK,Tott},{},"
+      "{WHITE,Tzarra},{BLACK,Tzarra,Tzarra},{},{WHITE,Tzaar},{BLACK,Tott},"
+      "{WHITE,Tott},{WHITE,Tott},{},{BLACK,Tzaar},{},{},{BLACK,Tzaar},"
+      "{BLACK,Tzarra},{BLACK,Tott},{},{},{BLACK,Tzarra,Tzarra},{},{},"
+      "{WHITE,Tzarra},{WHITE,Tott},{BLACK,Tott},{},{BLACK,Tzarra},{},"
+      "{BLACK,Tzaar},{BLACK,Tott},{WHITE,Tott},{WHITE,Tzarra},{},"
+      "{WHITE,Tzaar,Tzaar,Tzaar},{WHITE,Tott}"
+      "}",
+    false },
+  { "midgame 7",
+      "BoardState{"
+      "{WHITE,Tott},{BLACK,Tott},{WHITE,Tott},{BLACK,Tott},{WHITE,Tott},"
+      "{BLACK,Tott},{BLACK,Tzarra},{BLACK,Tzarra},{},{BLACK,Tott},"
+      "{BLACK,Tott},{WHITE,Tott},{},{WHITE,Tzaar},{WHITE,Tzarra},"
+      "{WHITE,Tzarra},{WHITE,Tzarra},{WHITE,Tott},{BLACK,Tott},"
+      "{WHITE,Tzarra},{BLACK,Tzarra},{WHITE,Tzaar},{BLACK,Tzaar},"
+      "{BLACK,Tzarra},{BLACK,Tzarra},{BLACK,Tott},{WHITE,Tott},"
+      "{WHITE,Tott,Tott,Tott},{WHITE,Tzarra},{BLACK,Tzaar},{WHITE,Tzaar},"
+      "{WHITE,Tzaar},{BLACK,Tzarra},{WHITE,Tott},{BLACK,Tott},{},"
+      "{BLACK,Tzaar},{BLACK,Tzaar},{},{BLACK,Tzaar},{},{BLACK,Tott},"
+      "{WHITE,Tott},{},{BLACK,Tzarra},{},{WHITE,Tzarra},{WHITE,Tzarra},"
+      "{WHITE,Tott},{BLACK,Tott},{},{BLACK,Tzarra,Tzarra},{},{BLACK,Tott},"
+      "{BLACK,Tott},{WHITE,Tott},{},{},{BLACK,Tott},{WHITE,Tott}"
+      "}",
+    false },
+  { "midgame 8",
+      "BoardState{"
+      "{WHITE,Tott},{BLACK,Tott},{},{},{WHITE,Tott},{BLACK,Tott},"
+      "{WHITE,Tott},{BLACK,Tzarra},{WHITE,Tott},{BLACK,Tott},{BLACK,Tott},"
+      "{WHITE,Tott},{BLACK,Tzarra},{WHITE,Tzaar},{BLACK,Tzaar},"
+      "{WHITE,Tzarra},{BLACK,Tzarra},{BLACK,Tott},{BLACK,Tott},{BLACK,Tott},"
+      "{BLACK,Tzarra},{WHITE,Tzaar},{BLACK,Tzaar},{},{BLACK,Tzarra},{},"
+      "{WHITE,Tott},{},{WHITE,Tzarra},{BLACK,Tzaar},{},{WHITE,Tzaar},"
+      "{WHITE,Tott},{WHITE,Tott},{BLACK,Tott},{WHITE,Tzarra},{BLACK,Tzaar},"
+      "{WHITE,Tzaar},{WHITE,Tzaar},{BLACK,Tzarra,Tzarra,Tzarra},{},{},{},"
+      "{WHITE,Tott},{WHITE,Tzaar},{BLACK,Tzarra},{WHITE,Tzarra},"
+      "{WHITE,Tzarra},{WHITE,Tott},{WHITE,Tott},{},{BLACK,Tzarra},"
+      "{WHITE,Tott,Tott},{BLACK,Tott},{BLACK,Tott},{WHITE,Tott},{BLACK,Tott},"
+      "{},{BLACK,Tott},{WHITE,Tott}"
+      "}",
+    false },
+  { "midgame 9",
+      "BoardState{"
+      "{WHITE,Tott},{BLACK,Tott},{WHITE,Tott},{},{},{BLACK,Tott},{},"
+      "{BLACK,Tzarra},{},{BLACK,Tott},{WHITE,Tott},{WHITE,Tott},{WHITE,Tott},"
+      "{WHITE,Tzaar},{BLACK,Tott,Tott},{WHITE,Tzarra},{},{},{},"
+      "{WHITE,Tzarra,Tzarra},{},{WHITE,Tzaar},{BLACK,Tzaar},{WHITE,Tzarra},"
+      "{WHITE,Tott},{BLACK,Tott},{WHITE,Tott},{BLACK,Tott,Tott},{},{},"
+      "{WHITE,Tzaar},{},{WHITE,Tott},{WHITE,Tott},{},{WHITE,Tzarra},{},"
+      "{BLACK,Tzaar},{BLACK,Tzaar},{BLACK,Tzaar},{WHITE,Tzaar},{},"
+      "{BLACK,Tzaar,Tzaar,Tzaar},{},{WHITE,Tzaar},{BLACK,Tzarra},"
+      "{BLACK,Tott},{WHITE,Tzarra},{},{WHITE,Tott},{},{BLACK,Tzarra},{},{},"
+      "{BLACK,Tott},{WHITE,Tott},{BLACK,Tott},{WHITE,Tott},{BLACK,Tott},"
+      "{WHITE,Tott}"
+      "}",
+    false },
+  { "midgame 10",
+      "BoardState{"
+      "{WHITE,Tott},{BLACK,Tott},{WHITE,Tott},{BLACK,Tott},{WHITE,Tott},"
+      "{BLACK,Tzarra,Tzarra},{WHITE,Tott},{BLACK,Tzarra},{WHITE,Tzarra},"
+      "{BLACK,Tott},{WHITE,Tott},{},{},{WHITE,Tzaar},{},{WHITE,Tzarra},{},{},"
+      "{},{WHITE,Tzarra},{BLACK,Tzarra},{WHITE,Tzaar},{BLACK,Tzaar},"
+      "{BLACK,Tzarra},{WHITE,Tott},{BLACK,Tott},{WHITE,Tott},{BLACK,Tott},{},"
+      "{BLACK,Tzaar},{WHITE,Tzaar},{WHITE,Tzaar},{},{BLACK,Tott},"
+      "{BLACK,Tott},{BLACK,Tzarra},{},{WHITE,Tzaar},{BLACK,Tzaar},"
+      "{BLACK,Tzaar},{BLACK,Tzarra},{},{},{},{WHITE,Tzarra,Tzarra,Tzarra},{},"
+      "{WHITE,Tzarra},{},{WHITE,Tott},{BLACK,Tzaar,Tzaar},{BLACK,Tzarra},{},"
+      "{WHITE,Tzarra},{WHITE,Tzarra},{BLACK,Tott},{WHITE,Tott},"
+      "{BLACK,Tzarra,Tzarra},{WHITE,Tott},{BLACK,Tott},{WHITE,Tott}"
+      "}",
+    false },
+  { "midgame 11",
+      "BoardState{"
+      "{},{WHITE,Tott},{},{BLACK,Tott},{BLACK,Tott},{},{WHITE,Tott},{},"
+      "{WHITE,Tzarra,Tzarra},{},{BLACK,Tott},{BLACK,Tott},{WHITE,Tzarra},"
+      "{WHITE,Tzaar},{},{},{},{WHITE,Tott},{BLACK,Tott},{},"
+      "{BLACK,Tzaar,Tzaar},{},{BLACK,Tzaar},{},{WHITE,Tzarra},{BLACK,Tott},"
+      "{},{WHITE,Tott},{WHITE,Tzarra},{},{WHITE,Tzaar},{BLACK,Tzaar,Tzaar},"
+      "{},{WHITE,Tott},{BLACK,Tott},{BLACK,Tzaar},{},{},{},{},{},"
+      "{BLACK,Tzarra},{BLACK,Tott},{BLACK,Tzarra},{},{},{},{BLACK,Tzaar},"
+      "{BLACK,Tott},{},{WHITE,Tzaar,Tzaar},{BLACK,Tzarra},{},{BLACK,Tott},{},"
+      "{BLACK,Tott},{},{},{WHITE,Tzarra,Tzarra,Tzarra},{WHITE,Tott}"
+      "}",
+    false },
+  { "midgame 12",
+      "BoardState{"
+      "{WHITE,Tott},{BLACK,Tott},{WHITE,Tzarra,Tzarra},{BLACK,Tott},"
+      "{WHITE,Tott},{},{WHITE,Tott},{BLACK,Tzarra},{},{BLACK,Tott},{},"
+      "{WHITE,Tott},{},{WHITE,Tzaar},{BLACK,Tzaar},{WHITE,Tzarra},"
+      "{BLACK,Tott},{WHITE,Tott},{},{BLACK,Tzarra,Tzarra,Tzarra},{},"
+      "{WHITE,Tzaar},{BLACK,Tzaar},{BLACK,Tzarra},{},{BLACK,Tott},"
+      "{BLACK,Tott},{WHITE,Tzarra},{},{BLACK,Tzaar},{WHITE,Tzaar},"
+      "{BLACK,Tzarra},{WHITE,Tott},{WHITE,Tott},{BLACK,Tott},{},"
+      "{BLACK,Tzaar},{},{BLACK,Tzaar},{},{BLACK,Tzaar,Tzaar},{BLACK,Tott},"
+      "{WHITE,Tzarra,Tzarra},{BLACK,Tzarra},{WHITE,Tzarra,Tzarra},"
+      "{WHITE,Tzaar},{WHITE,Tzarra},{BLACK,Tott},{WHITE,Tott},{BLACK,Tott},"
+      "{WHITE,Tott},{},{},{WHITE,Tott},{},{WHITE,Tott},{BLACK,Tott},"
+      "{WHITE,Tott},{BLACK,Tott},{}"
+      "}",
+    false },
+  { "midgame 13",
+      "BoardState{"
+      "{WHITE,Tott},{},{WHITE,Tott},{BLACK,Tott},{BLACK,Tott},{BLACK,Tott},"
+      "{WHITE,Tott},{BLACK,Tott,Tott},{WHITE,Tzarra},{BLACK,Tott},{},"
+      "{WHITE,Tott},{BLACK,Tzarra},{WHITE,Tzaar},{BLACK,Tzaar},"
+      "{WHITE,Tzarra},{},{WHITE,Tott},{},{},{},{WHITE,Tzaar},{BLACK,Tzaar},"
+      "{BLACK,Tzarra},{WHITE,Tzarra},{BLACK,Tott},{WHITE,Tzarra,Tzarra},"
+      "{BLACK,Tott},{BLACK,Tzarra,Tzarra},{BLACK,Tott,Tott,Tott},{},"
+      "{WHITE,Tzaar},{WHITE,Tott},{WHITE,Tott},{BLACK,Tott},{WHITE,Tzarra},"
+      "{},{WHITE,Tzaar},{BLACK,Tzaar},{WHITE,Tzaar},{BLACK,Tzarra},"
+      "{WHITE,Tott},{WHITE,Tott},{},{},{BLACK,Tzarra},{WHITE,Tzarra},"
+      "{WHITE,Tzarra},{},{},{WHITE,Tott,Tott},{},{WHITE,Tzarra},{BLACK,Tott},"
+      "{WHITE,Tott},{},{BLACK,Tott},{BLACK,Tzarra},{BLACK,Tott},{}"
+      "}",
+    false },
+  { "midgame 14",
+      "BoardState{"
+      "{WHITE,Tott},{BLACK,Tott},{},{WHITE,Tzarra,Tzarra},{WHITE,Tott},"
+      "{BLACK,Tott},{WHITE,Tott},{BLACK,Tzarra},{},{},{BLACK,Tott},{},"
+      "{BLACK,Tzarra},{WHITE,Tzaar},{BLACK,Tzaar},{BLACK,Tzaar},"
+      "{WHITE,Tzarra},{WHITE,Tott},{BLACK,Tott},{},{WHITE,Tzarra},"
+      "{WHITE,Tzaar},{},{BLACK,Tzarra},{BLACK,Tzarra},{BLACK,Tott},"
+      "{WHITE,Tott},{},{},{WHITE,Tzaar},{WHITE,Tzaar},{BLACK,Tzarra},"
+      "{WHITE,Tott},{WHITE,Tott},{BLACK,Tott},{WHITE,Tzarra},{},{},"
+      "{BLACK,Tzaar},{WHITE,Tzarra},{},{BLACK,Tott},{WHITE,Tott},{},"
+      "{BLACK,Tott,Tott,Tott},{BLACK,Tzarra},{WHITE,Tzarra},{},{WHITE,Tott},"
+      "{BLACK,Tzaar,Tzaar},{WHITE,Tott},{},{WHITE,Tzarra},{BLACK,Tott},"
+      "{BLACK,Tott},{WHITE,Tott},{BLACK,Tott},{WHITE,Tott},{WHITE,Tott},{}"
+      "}",
+    false },
+  { "endgame 1",
+      "BoardState{"
+      "{},{BLACK,Tzaar,Tzaar,Tzaar},{},{BLACK,Tott},{WHITE,Tzarra,Tzarra},{},"
+      "{},{},{},{},{},{WHITE,Tott,Tott,Tott},{},{WHITE,Tzaar},{},{},{},"
+      "{WHITE,Tott},{},{},{},{},{},{BLACK,Tzarra},{},{},{WHITE,Tott},{},{},"
+      "{WHITE,Tzaar},{WHITE,Tzaar},{},{},{BLACK,Tzarra,Tzarra},"
+      "{WHITE,Tzarra},{BLACK,Tott,Tott},{},{},{},{BLACK,Tzaar},{},{},{},"
+      "{WHITE,Tzaar},{},{BLACK,Tzarra},{BLACK,Tott,Tott},{WHITE,Tzarra},{},"
+      "{},{},{},{BLACK,Tzarra},{},{},{WHITE,Tott,Tott},{},{},{},{BLACK,Tott}"
+      "}",
+    false },
+  { "endgame 2",
+      "BoardState{"
+      "{},{BLACK,Tott,Tott},{},{},{},{},{},{WHITE,Tott},{},{},{},"
+      "{WHITE,Tott},{},{},{},{WHITE,Tzarra},{WHITE,Tott},{WHITE,Tzaar},"
+      "{BLACK,Tott},{BLACK,Tott},{},{WHITE,Tott},{},{},{},{},{},{},{},{},{},"
+      "{},{},{WHITE,Tott},{BLACK,Tzaar},{},{},{},{},{},{},{BLACK,Tzarra},"
+      "{BLACK,Tzarra,Tzarra,Tzarra},{},{WHITE,Tzaar},{},{WHITE,Tzarra},{},{},"
+      "{BLACK,Tzaar,Tzaar},{},{},{},{WHITE,Tzaar},{WHITE,Tzarra},"
+      "{WHITE,Tott},{WHITE,Tott},{},{},{WHITE,Tott}"
+      "}",
+    false },
+  { "endgame 3",
+      "BoardState{"
+      "{WHITE,Tott},{WHITE,Tzarra,Tzarra},{},{},{WHITE,Tott},{},{},"
+      "{BLACK,Tott,Tott},{},{},{BLACK,Tott},{},{},{},{},{BLACK,Tzaar,Tzaar},"
+      "{},{},{WHITE,Tott},{BLACK,Tzarra,Tzarra,Tzarra},{WHITE,Tzaar},{},{},"
+      "{},{},{},{WHITE,Tott},{},{},{WHITE,Tott,Tott},{},{},{BLACK,Tott,Tott},"
+      "{},{BLACK,Tott},{BLACK,Tzaar},{},{},{},{WHITE,Tzaar},{},{},{},{},{},"
+      "{},{BLACK,Tott},{WHITE,Tzarra},{BLACK,Tzarra},{},{},{},{},{},"
+      "{WHITE,Tott},{WHITE,Tott},{BLACK,Tott},{},{},{}"
+      "}",
+    false },
+  { "endgame 4",
+      "BoardState{"
+      "{WHITE,Tott},{},{},{WHITE,Tzarra},{WHITE,Tott},{},{BLACK,Tott},"
+      "{WHITE,Tott},{},{},{},{},{},{},{WHITE,Tzaar},{},{},"
+      "{WHITE,Tzarra,Tzarra},{WHITE,Tott},{},{BLACK,Tzaar},{WHITE,Tzaar},{},"
+      "{},{},{BLACK,Tzarra,Tzarra,Tzarra},{},{WHITE,Tzarra,Tzarra},{},{},{},"
+      "{},{WHITE,Tott},{WHITE,Tott},{},{},{},{BLACK,Tott},{BLACK,Tzaar},"
+      "{BLACK,Tott,Tott},{},{},{},{},{},{BLACK,Tott,Tott,Tott,Tott},{},{},{},"
+      "{},{},{},{},{BLACK,Tzarra},{},{},{BLACK,Tzarra},{WHITE,Tzarra,Tzarra},"
+      "{},{}"
+      "}",
+    false },
+  { "endgame 5",
+      "BoardState{"
+      "{},{BLACK,Tott},{WHITE,Tzarra},{BLACK,Tott},{WHITE,Tott},{BLACK,Tott},"
+      "{BLACK,Tott,Tott},{},{},{},{},{WHITE,Tott,Tott},{BLACK,Tzarra},"
+      "{WHITE,Tzaar},{},{},{},{BLACK,Tott,Tott},{},{},{},{WHITE,Tzarra},{},"
+      "{},{},{},{},{},{BLACK,Tott},{},{},{},{WHITE,Tzaar,Tzaar},{WHITE,Tott},"
+      "{},{},{},{BLACK,Tzaar},{BLACK,Tzarra,Tzarra},{},{},{WHITE,Tott},{},{},"
+      "{BLACK,Tzarra},{BLACK,Tzarra},{},{BLACK,Tzaar,Tzaar},{},{},"
+      "{WHITE,Tzarra,Tzarra},{},{},{},{},{WHITE,Tott},{BLACK,Tott},{},"
+      "{WHITE,Tott},{WHITE,Tott}"
+      "}",
+    false },
+  { "endgame 6",
+      "BoardState{"
+      "{BLACK,Tott},{},{WHITE,Tott},{BLACK,Tott},{},{BLACK,Tott},"
+      "{WHITE,Tott},{},{},{WHITE,Tzarra,Tzarra},{BLACK,Tzarra,Tzarra},{},"
+      "{BLACK,Tzarra},{BLACK,Tzarra},{},{},{},{},{},{},{},{WHITE,Tzaar},{},"
+      "{},{},{WHITE,Tott,Tott},{BLACK,Tott},{},{WHITE,Tott,Tott},"
+      "{BLACK,Tzaar},{},{BLACK,Tzaar},{},{},{},{},{BLACK,Tzaar},"
+      "{WHITE,Tzaar},{},{},{WHITE,Tott,Tott},{},{},{},{},{BLACK,Tzarra},"
+      "{BLACK,Tzaar},{},{},{},{WHITE,Tott},{},{},{},{},{BLACK,Tott,Tott},{},"
+      "{BLACK,Tott},{BLACK,Tott},{WHITE,Tzarra,Tzarra}"
+      "}",
+    false },
+  { "endgame 7",
+      "BoardState{"
+      "{},{WHITE,Tzarra,Tzarra},{},{},{BLACK,Tzaar,Tzaar,Tzaar,Tzaar},"
+      "{WHITE,Tott},{},{BLACK,Tzarra},{WHITE,Tzarra},{},{},{},{},"
+      "{WHITE,Tzaar},{},{},{BLACK,Tott},{},{WHITE,Tott},{},{},{},{},"
+      "{WHITE,Tzaar},{BLACK,Tzarra},{},{BLACK,Tott},{WHITE,Tzaar},{},{},{},"
+      "{},{BLACK,Tott},{WHITE,Tott},{},{WHITE,Tzarra},{BLACK,Tzaar},"
+      "{WHITE,Tott,Tott},{WHITE,Tzarra},{WHITE,Tzaar},{},{},{BLACK,Tzarra},"
+      "{},{},{},{},{BLACK,Tzarra,Tzarra,Tzarra},{WHITE,Tott},{},{},"
+      "{WHITE,Tott},{WHITE,Tott},{},{},{BLACK,Tott},{},{},{},{}"
+      "}",
+    false },
+  { "endgame 8",
+      "BoardState{"
+      "{},{BLACK,Tott},{},{BLACK,Tzaar,Tzaar},{WHITE,Tott},{WHITE,Tott},{},"
+      "{},{},{BLACK,Tott},{},{WHITE,Tott},{WHITE,Tott},{BLACK,Tzarra},{},{},"
+      "{},{BLACK,Tzarra},{WHITE,Tott},{},{},{WHITE,Tzaar},{WHITE,Tzarra},"
+      "{WHITE,Tzaar,Tzaar},{},{},{},{BLACK,Tott,Tott},{WHITE,Tzarra},"
+      "{WHITE,Tzarra},{},{BLACK,Tott,Tott},{},{BLACK,Tott,Tott},{},{},{},{},"
+      "{},{},{},{},{BLACK,Tzaar,Tzaar},{},{BLACK,Tzarra},{},{WHITE,Tzarra},"
+      "{WHITE,Tzarra},{},{WHITE,Tzaar,Tzaar},{},{},{},{},{},{WHITE,Tott},{},"
+      "{BLACK,Tott},{},{}"
+      "}",
+    false },
+  { "endgame 9",
+      "BoardState{"
+      "{},{BLACK,Tott},{BLACK,Tzarra},{},{BLACK,Tott},{BLACK,Tott},{},{},{},"
+      "{BLACK,Tott},{},{},{},{WHITE,Tott,Tott},{},{},{WHITE,Tzarra},{},"
+      "{WHITE,Tott},{BLACK,Tott},{},{BLACK,Tzaar,Tzaar},{},{},{},"
+      "{WHITE,Tott},{},{},{},{BLACK,Tzaar},{},{BLACK,Tzaar},{WHITE,Tott},"
+      "{WHITE,Tott},{},{BLACK,Tzaar,Tzaar},{},{},{},{},{},"
+      "{BLACK,Tzarra,Tzarra},{BLACK,Tott},{WHITE,Tott},{},"
+      "{WHITE,Tzaar,Tzaar},{WHITE,Tzarra},{WHITE,Tzaar},{WHITE,Tott},{},{},"
+      "{},{},{WHITE,Tott},{},{},{},{},{WHITE,Tzarra},{}"
+      "}",
+    false },
+  { "endgame 10",
+      "BoardState{"
+      "{WHITE,Tott},{},{BLACK,Tott},{BLACK,Tott},{},{BLACK,Tzaar,Tzaar},{},"
+      "{WHITE,Tott},{},{},{},{BLACK,Tzarra},{},{},{WHITE,Tzaar},"
+      "{BLACK,Tzarra,Tzarra},{},{BLACK,Tott},{BLACK,Tzarra},{},{},"
+      "{WHITE,Tzaar},{},{},{},{},{WHITE,Tott},{},{},{},{},{BLACK,Tzaar},"
+      "{BLACK,Tzarra},{},{WHITE,Tzarra},{},{},{},{WHITE,Tott},{},{},"
+      "{BLACK,Tott},{WHITE,Tott},{},{},{},{WHITE,Tzarra},{},{BLACK,Tzarra},"
+      "{BLACK,Tzaar,Tzaar},{},{},{WHITE,Tzarra,Tzarra,Tzarra},{},"
+      "{WHITE,Tzarra},{WHITE,Tott},{WHITE,Tott},{},{},{}"
+      "}",
+    false },
+  { "endgame 11",
+      "BoardState{"
+      "{BLACK,Tott},{},{},{BLACK,Tott},{},{},{BLACK,Tott},{WHITE,Tott},"
+      "{BLACK,Tzaar},{},{},{},{BLACK,Tzarra},{WHITE,Tzaar},{},{},"
+      "{WHITE,Tott,Tott},{BLACK,Tott},{BLACK,Tott},{WHITE,Tott,Tott},{},{},"
+      "{BLACK,Tzaar},{WHITE,Tott,Tott},{},{BLACK,Tott},{WHITE,Tott},{},{},{},"
+      "{},{BLACK,Tzarra},{},{WHITE,Tott},{},{},{WHITE,Tzaar,Tzaar},{},"
+      "{BLACK,Tzaar},{BLACK,Tzaar},{},{},{},{},{},{},{},{},{},"
+      "{WHITE,Tzarra,Tzarra},{BLACK,Tzaar,Tzaar,Tzaar,Tzaar},{},"
+      "{WHITE,Tzarra,Tzarra,Tzarra},{},{},{BLACK,Tott,Tott},{},{},{},"
+      "{BLACK,Tzarra,Tzarra}"
+      "}",
+    false },
+  { "endgame 12",
+      "BoardState{"
+      "{WHITE,Tott},{BLACK,Tott},{WHITE,Tott},{BLACK,Tott,Tott},{BLACK,Tott},"
+      "{},{},{BLACK,Tzarra},{WHITE,Tzarra},{},{},{},{BLACK,Tzarra,Tzarra},{},"
+      "{},{},{BLACK,Tzarra},{},{},{},{},{},{},{},{},"
+      "{WHITE,Tzarra,Tzarra,Tzarra,Tzarra,Tzarra},{BLACK,Tott,Tott},{},"
+      "{WHITE,Tzarra},{},{},{},{WHITE,Tott},{},{},{},{},{WHITE,Tzaar},{},{},"
+      "{WHITE,Tzaar},{},{},{WHITE,Tzarra,Tzarra,Tzarra},{WHITE,Tzaar},"
+      "{WHITE,Tzarra},{},{WHITE,Tzarra},{BLACK,Tott},{BLACK,Tott},{},{},"
+      "{BLACK,Tzaar,Tzaar},{},{},{WHITE,Tott},{},{},{BLACK,Tott,Tott},"
+      "{BLACK,Tzaar}"
+      "}",
+    false },
+};
+
+const int Bench::kNumPositions = sizeof(kPositions) / sizeof(kPositions[0]);
+
+Bench::Bench(int depth, int hash_mb, int qsearch_depth, int threads,
+    int tzaar_coefficient, int tzarra_coefficient, int tott_coefficient,
+    int stack_coefficient)
+    : depth_(depth),
+      hash_mb_(hash_mb),
+      qsearch_depth_(qsearch_depth),
+      threads_(threads),
+      tzaar_coefficient_(tzaar_coefficient),
+      tzarra_coefficient_(tzarra_coefficient),
+      tott_coefficient_(tott_coefficient),
+      stack_coefficient_(stack_coefficient) {}
+
+/// Only the searches are timed, not setting up the game for each position,
+/// and the games are quiet, so that writing to the console is not timed
+/// either.
+///
+void Bench::Run(std::ostream &out) {
+  uint64_t total_nodes = 0;
+  uint64_t signature = kSignatureBasis;
+  Clock::duration elapsed(0);
+
+  for (int i = 0; i < kNumPositions; ++i) {
+    const Position &position = kPositions[i];
+
+    TzaarGame game(0, depth_, (std::numeric_limits<int>::max)(), hash_mb_,
+        qsearch_depth_, threads_, tzaar_coefficient_, tzarra_coefficient_,
+        tott_coefficient_, stack_coefficient_);
+    game.set_quiet(true);
+    game.set_timed(false);
+    game.set_player_number("One");
+    game.set_current_state(GameState(
+        wm::BoardStateMessage(position.board_state).board_state()));
+    game.set_turn_count(position.opening ? 0 : 1);
+
+    Clock::time_point start = Clock::now();
+    wm::MoveMessage move = game.GetNextMove(true);
+    elapsed += Clock::now() - start;
+
+    uint64_t nodes = game.search_nodes();
+    total_nodes += nodes;
+
+    HashInto(signature, nodes);
+    HashInto(signature, move.pass());
+    HashInto(signature, move.from_column());
+    HashInto(signature, move.from_row());
+    HashInto(signature, move.to_column());
+    HashInto(signature, move.to_row());
+
+    out << "bench " << i + 1 << " (" << position.name << "): "
+        << nodes << " nodes, move " << move.payload() << std::endl;
+  }
+
+  double seconds = std::chrono::duration<double>(elapsed).count();
+
+  out << "Positions: " << kNumPositions << " at depth " << depth_ << std::endl;
+  out << "Total nodes: " << total_nodes << std::endl;
+  out << "Total time: " << std::fixed << std::setprecision(3) << seconds
+      << " s" << std::endl;
+  if (seconds > 0)
+    out << "Nodes/sec: " << std::setprecision(0) << total_nodes / seconds
+        << std::endl;
+  out << "Signature: " << std::hex << std::setw(16) << std::setfill('0')
+      << signature << std::dec << std::setfill(' ') << std::endl;
+}
+
+} // namespace wartzaar
@@ -0,0 +1,62 @@
+#ifndef WARTZAAR_BENCH_H_
+#define WARTZAAR_BENCH_H_
+
+#include <stdint.h>
+
+#include <iosfwd>
+
+namespace wartzaar {
+
+///-----------------------------------------------------------------------------
+/// Bench searches a fixed set of positions to a fixed depth, and reports the
+/// nodes searched, the time taken and a signature of the results.
+///
+/// The positions cover the opening, midgame positions with stacks of three or
+/// more, and endgames where a player is down to two tzaars. Each
+/// position is searched by a new game, with white to move at the start of a
+/// turn, so the results of one position do not depend on the others.
+///
+/// With one thread the search is the same on every run, so the signature only
+/// changes when the search itself does: the node count, or the move chosen,
+/// of any position. Changes meant only to make the search faster should leave
+/// it alone. The nodes per second then compare the speed of two builds on the
+/// same trees.
+///-----------------------------------------------------------------------------
+class Bench {
+ public:
+  /// A benchmark position, as a BoardState message. The opening is searched
+  /// as the single capturing move of the first turn.
+  struct Position {
+    const char *name;
+    const char *board_state;
+    bool opening;
+  };
+
+  /// The benchmark positions.
+  static const Position kPositions[];
+  static const int kNumPositions;
+
+  /// Constructor takes the search depth, and the settings of the game that
+  /// searches each position.
+  Bench(int depth, int hash_mb, int qsearch_depth, int threads,
+      int tzaar_coefficient, int tzarra_coefficient, int tott_coefficient,
+      int stack_coefficient);
+
+  /// Searches every position, writing the nodes and move of each, and the
+  /// totals and signature, to out.
+  void Run(std::ostream &out);
+
+ private:
+  int depth_;
+  int hash_mb_;
+  int qsearch_depth_;
+  int threads_;
+  int tzaar_coefficient_;
+  int tzarra_coefficient_;
+  int tott_coefficient_;
+  int stack_coefficient_;
+};
+
+} // namespace wartzaar
+
+#endif // WARTZAAR_BENCH_H_
@@ -0,0 +1,62 @@
+#ifndef WARTZAAR_BITBOARD_H_
+#define WARTZAAR_BITBOARD_H_
+
+#include <stdint.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace wartzaar {
+
+///-----------------------------------------------------------------------------
+/// Bit scanning helpers for the 64-bit cell masks used by GameBoard.
+///
+/// The masks passed to these functions must not be zero.
+///-----------------------------------------------------------------------------
+
+/// Returns the number of the lowest set bit in the given mask.
+inline int LowestBit(uint64_t mask) {
+#if defined(_MSC_VER) && defined(_M_X64)
+  unsigned long index;
+  _BitScanForward64(&index, mask);
+  return static_cast<int>(index);
+#elif defined(_MSC_VER)
+  unsigned long index;
+  if (_BitScanForward(&index, static_cast<unsigned long>(mask)))
+    return static_cast<int>(index);
+  _BitScanForward(&index, static_cast<unsigned long>(mask >> 32));
+  return static_cast<int>(index) + 32;
+#else
+  return __builtin_ctzll(mask);
+#endif
+}
+
+/// Returns the number of the highest set bit in the given mask.
+inline int HighestBit(uint64_t mask) {
+#if defined(_MSC_VER) && defined(_M_X64)
+  unsigned long index;
+  _BitScanReverse64(&index, mask);
+  return static_cast<int>(index);
+#elif defined(_MSC_VER)
+  unsigned long index;
+  if (_BitScanReverse(&index, static_cast<unsigned long>(mask >> 32)))
+    return static_cast<int>(index) + 32;
+  _BitScanReverse(&index, static_cast<unsigned long>(mask));
+  return static_cast<int>(index);
+#else
+  return 63 - __builtin_clzll(mask);
+#endif
+}
+
+/// Clears the lowest set bit of the given mask and returns its number. This is
+/// used to iterate over the cells in a mask.
+inline int PopLowestBit(uint64_t &mask) {
+  int bit = LowestBit(mask);
+  mask &= mask - 1;
+  return bit;
+}
+
+} // namespace wartzaar
+
+#endif // WARTZAAR_BITBOARD_H_
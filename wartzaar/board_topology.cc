@@ -0,0 +1,107 @@
+#include "wartzaar/board_topology.h"
+
+namespace wartzaar {
+
+const int BoardTopology::kColumnStart[BoardTopology::kNumColumns] =
+    { 0, 5, 11, 18, 26, 34, 42, 49, 55 };
+const int BoardTopology::kColumnSize[BoardTopology::kNumColumns] =
+    { 5, 6, 7, 8, 8, 8, 7, 6, 5 };
+
+unsigned char BoardTopology::col_[BoardTopology::kNumCells];
+unsigned char BoardTopology::row_[BoardTopology::kNumCells];
+signed char BoardTopology::ray_cells_[BoardTopology::kNumCells][6]
+    [BoardTopology::kMaxRayLength];
+unsigned char BoardTopology::ray_length_[BoardTopology::kNumCells][6];
+uint64_t BoardTopology::ray_mask_[BoardTopology::kNumCells][6];
+
+namespace {
+
+/// The axial coordinate steps for each direction, indexed by direction - 1.
+///
+/// The x axis runs along the columns (x = col - 4) and the y axis runs north
+/// along each column, so the center of the board is at (0, 0).
+///
+const int kDirectionStep[6][2] = {
+  {  0,  1 },  // north
+  {  1,  0 },  // northeast
+  {  1, -1 },  // southeast
+  {  0, -1 },  // south
+  { -1,  0 },  // southwest
+  { -1,  1 }   // northwest
+};
+
+} // namespace
+
+///-----------------------------------------------------------------------------
+/// BoardTopologyBuilder fills in the board topology when the program starts.
+///-----------------------------------------------------------------------------
+class BoardTopologyBuilder {
+ public:
+  BoardTopologyBuilder();
+
+ private:
+  /// Returns the cell at the given axial coordinates, or kNoCell for the
+  /// center hole and for coordinates off the board.
+  static int CellAt(int x, int y);
+};
+
+BoardTopologyBuilder::BoardTopologyBuilder() {
+  for (int col = 0; col < BoardTopology::kNumColumns; ++col) {
+    for (int row = 0; row < BoardTopology::kColumnSize[col]; ++row) {
+      int cell = BoardTopology::kColumnStart[col] + row;
+      BoardTopology::col_[cell] = static_cast<unsigned char>(col);
+      BoardTopology::row_[cell] = static_cast<unsigned char>(row);
+    }
+  }
+
+  for (int cell = 0; cell < BoardTopology::kNumCells; ++cell) {
+    int col = BoardTopology::col_[cell];
+    int row = BoardTopology::row_[cell];
+
+    // The center column skips the hole between rows 3 and 4.
+    int x = col - 4;
+    int y = (col == 4 && row > 3 ? row + 1 : row) - (col < 4 ? col : 4);
+
+    for (int dir = 0; dir < 6; ++dir) {
+      int length = 0;
+      uint64_t mask = 0;
+      int ray_x = x + kDirectionStep[dir][0];
+      int ray_y = y + kDirectionStep[dir][1];
+      int ray_cell;
+
+      while ((ray_cell = CellAt(ray_x, ray_y)) != BoardTopology::kNoCell) {
+        BoardTopology::ray_cells_[cell][dir][length++] =
+            static_cast<signed char>(ray_cell);
+        mask |= static_cast<uint64_t>(1) << ray_cell;
+        ray_x += kDirectionStep[dir][0];
+        ray_y += kDirectionStep[dir][1];
+      }
+
+      BoardTopology::ray_length_[cell][dir] =
+          static_cast<unsigned char>(length);
+      BoardTopology::ray_mask_[cell][dir] = mask;
+    }
+  }
+}
+
+int BoardTopologyBuilder::CellAt(int x, int y) {
+  if (x < -4 || x > 4 || y < -4 || y > 4 || x + y < -4 || x + y > 4)
+    return BoardTopology::kNoCell;
+  if (x == 0 && y == 0)
+    return BoardTopology::kNoCell;
+
+  int col = x + 4;
+  int row = y + (col < 4 ? col : 4);
+  if (col == 4 && row > 4)
+    --row;
+
+  return BoardTopology::kColumnStart[col] + row;
+}
+
+namespace {
+
+const BoardTopologyBuilder kBoardTopologyBuilder;
+
+} // namespace
+
+} // namespace wartzaar
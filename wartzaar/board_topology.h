@@ -0,0 +1,135 @@
+#ifndef WARTZAAR_BOARD_TOPOLOGY_H_
+#define WARTZAAR_BOARD_TOPOLOGY_H_
+
+#include <stdint.h>
+
+#include "wartzaar/bitboard.h"
+#include "wartzaar/types/direction.h"
+
+namespace wartzaar {
+
+///-----------------------------------------------------------------------------
+/// BoardTopology holds the fixed geometry of the Tzaar board: the numbering of
+/// the 60 cells, their columns and rows, and the rays leaving each cell in
+/// each of the six directions.
+///
+/// Cells are numbered column by column from the bottom of the leftmost column.
+/// The center column has a hole between rows 3 and 4, which is not a cell.
+///
+/// A ray is the ordered list of cells reached by stepping from a cell in one
+/// direction until the edge of the board or the center hole. Cell numbers
+/// increase along the north, northeast and southeast rays and decrease along
+/// the others, so the first occupied cell on a ray is found with a single bit
+/// scan.
+///
+/// The geometry never changes. It is built once, when the program starts, and
+/// shared by every board, so a board only has to carry its pieces.
+///-----------------------------------------------------------------------------
+class BoardTopology {
+ public:
+  /// The number of cells on the board.
+  static const int kNumCells = 60;
+
+  /// The number of columns on the board.
+  static const int kNumColumns = 9;
+
+  /// The value returned by the cell lookups when no cell exists.
+  static const int kNoCell = -1;
+
+  /// The longest possible ray, from one edge of the board to the other.
+  static const int kMaxRayLength = 8;
+
+  /// Returns the number of the cell at the given column and row.
+  static int Cell(int col, int row);
+
+  /// Returns the column of the given cell.
+  static int Col(int cell);
+
+  /// Returns the row of the given cell within its column.
+  static int Row(int cell);
+
+  /// Returns the number of cells in the given column.
+  static int ColumnSize(int col);
+
+  /// Returns the number of cells on the ray leaving the given cell in the
+  /// given direction.
+  static int RayLength(int cell, wartzaar::types::direction::Direction dir);
+
+  /// Returns the i-th cell on the ray leaving the given cell in the given
+  /// direction, counting from the nearest.
+  static int RayCell(int cell, wartzaar::types::direction::Direction dir,
+      int i);
+
+  /// Returns the mask of all cells on the ray leaving the given cell in the
+  /// given direction.
+  static uint64_t RayMask(int cell, wartzaar::types::direction::Direction dir);
+
+  /// Returns the nearest cell in the given occupancy mask on the ray leaving
+  /// the given cell in the given direction, or kNoCell if the ray is empty.
+  static int FirstBlocker(int cell, wartzaar::types::direction::Direction dir,
+      uint64_t occupied);
+
+ private:
+  friend class BoardTopologyBuilder;
+
+  /// The cell number of the bottom cell of each column.
+  static const int kColumnStart[kNumColumns];
+
+  /// The number of cells in each column.
+  static const int kColumnSize[kNumColumns];
+
+  /// The column and row of each cell.
+  static unsigned char col_[kNumCells];
+  static unsigned char row_[kNumCells];
+
+  /// The rays, indexed by cell and direction - 1.
+  static signed char ray_cells_[kNumCells][6][kMaxRayLength];
+  static unsigned char ray_length_[kNumCells][6];
+  static uint64_t ray_mask_[kNumCells][6];
+};
+
+inline int BoardTopology::Cell(int col, int row) {
+  return kColumnStart[col] + row;
+}
+
+inline int BoardTopology::Col(int cell) {
+  return col_[cell];
+}
+
+inline int BoardTopology::Row(int cell) {
+  return row_[cell];
+}
+
+inline int BoardTopology::ColumnSize(int col) {
+  return kColumnSize[col];
+}
+
+inline int BoardTopology::RayLength(int cell,
+    wartzaar::types::direction::Direction dir) {
+  return ray_length_[cell][dir - 1];
+}
+
+inline int BoardTopology::RayCell(int cell,
+    wartzaar::types::direction::Direction dir, int i) {
+  return ray_cells_[cell][dir - 1][i];
+}
+
+inline uint64_t BoardTopology::RayMask(int cell,
+    wartzaar::types::direction::Direction dir) {
+  return ray_mask_[cell][dir - 1];
+}
+
+inline int BoardTopology::FirstBlocker(int cell,
+    wartzaar::types::direction::Direction dir, uint64_t occupied) {
+  uint64_t blockers = ray_mask_[cell][dir - 1] & occupied;
+
+  if (blockers == 0)
+    return kNoCell;
+
+  return dir <= wartzaar::types::direction::kSoutheast
+      ? LowestBit(blockers) : HighestBit(blockers);
+}
+
+} // namespace wartzaar
+
+#endif // WARTZAAR_BOARD_TOPOLOGY_H_
@@ -0,0 +1,39 @@
+#include "wartzaar/clock.h"
+
+#if defined(_MSC_VER) && _MSC_VER < 1900
+
+#include <stdint.h>
+#include <windows.h>
+
+namespace wartzaar {
+
+namespace {
+
+/// Returns the number of performance counter ticks per second.
+int64_t CounterFrequency() {
+  LARGE_INTEGER frequency;
+  QueryPerformanceFrequency(&frequency);
+  return frequency.QuadPart;
+}
+
+/// Read once at startup; the frequency is fixed while the system runs.
+const int64_t kCounterFrequency = CounterFrequency();
+
+} // namespace
+
+/// The whole seconds and the remaining ticks are converted apart, so that
+/// the count of nanoseconds cannot overflow.
+///
+Clock::time_point Clock::now() {
+  LARGE_INTEGER counter;
+  QueryPerformanceCounter(&counter);
+
+  int64_t seconds = counter.QuadPart / kCounterFrequency;
+  int64_t ticks = counter.QuadPart % kCounterFrequency;
+  return time_point(duration(seconds * 1000000000
+      + ticks * 1000000000 / kCounterFrequency));
+}
+
+} // namespace wartzaar
+
+#endif
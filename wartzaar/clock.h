@@ -0,0 +1,37 @@
+#ifndef WARTZAAR_CLOCK_H_
+#define WARTZAAR_CLOCK_H_
+
+#include <chrono>
+
+namespace wartzaar {
+
+#if defined(_MSC_VER) && _MSC_VER < 1900
+
+///-----------------------------------------------------------------------------
+/// Clock is a monotonic clock for timing searches.
+///
+/// The steady_clock of Visual C++ 2013 is not steady: it reads the system
+/// time, which jumps when the time of day is set, and only ticks every few
+/// milliseconds. This clock reads the performance counter instead.
+///-----------------------------------------------------------------------------
+struct Clock {
+  typedef std::chrono::nanoseconds duration;
+  typedef duration::rep rep;
+  typedef duration::period period;
+  typedef std::chrono::time_point<Clock> time_point;
+  static const bool is_steady = true;
+
+  /// Returns the current time.
+  static time_point now();
+};
+
+#else
+
+/// Clock is a monotonic clock for timing searches.
+typedef std::chrono::steady_clock Clock;
+
+#endif
+
+} // namespace wartzaar
+
+#endif // WARTZAAR_CLOCK_H_
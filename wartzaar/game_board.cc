@@ -1,313 +1,149 @@
 #include "wartzaar/game_board.h"
 
-#include <iomanip>
-#include <iostream>
-#include <sstream>
+#include <string.h>  // for memcmp, memset
+
 #include <stdexcept>
 
 #include "wartzaar/game_board_position.h"
 
 namespace wtc = wartzaar::types::color;
+namespace wtd = wartzaar::types::direction;
+namespace wtpt = wartzaar::types::piecetype;
 
 namespace wartzaar {
 
+namespace {
+
+inline uint64_t CellBit(int cell) {
+  return static_cast<uint64_t>(1) << cell;
+}
+
+} // namespace
+
 GameBoard::GameBoard() {
-  Init();
+  memset(color_mask_, 0, sizeof(color_mask_));
+  memset(type_mask_, 0, sizeof(type_mask_));
+  memset(stack_height_, 0, sizeof(stack_height_));
 }
 
-/// Copy constructor copies the stack of pieces from each cell in the source
-/// board to the same cell in the new board.
-///
-GameBoard::GameBoard(const GameBoard &that) {
-  Init();
-
-  for (size_t col = 0; col < board_.size(); ++col) {
-    for (size_t row = 0; row < board_[col].size(); ++row) {
-      board_[col][row].set_stack_height(that.board_[col][row].stack_height());
-      board_[col][row].set_color(that.board_[col][row].color());
-      board_[col][row].set_type(that.board_[col][row].type());
-    }
-  }
+void GameBoard::AddPiece(wtc::Color color, wtpt::PieceType type, int cell) {
+  AddPieces(color, type, 1, cell);
 }
 
-/// Assignment operator copies the stack of pieces from each cell in the source
-/// board to the same cell in the new board.
-///
-GameBoard &GameBoard::operator=(const GameBoard &that) {
-  for (size_t col = 0; col < board_.size(); ++col) {
-    for (size_t row = 0; row < board_[col].size(); ++row) {
-      board_[col][row].set_stack_height(that.board_[col][row].stack_height());
-      board_[col][row].set_color(that.board_[col][row].color());
-      board_[col][row].set_type(that.board_[col][row].type());
-    }
-  }
-
-  return *this;
+void GameBoard::AddPiece(wtc::Color color, wtpt::PieceType type, int col,
+    int row) {
+  AddPieces(color, type, 1, CalculateCell(col, row));
 }
 
-void GameBoard::Init() {
-  board_.clear();
-  board_.push_back(std::vector<GameBoardPosition>(5));
-  board_.push_back(std::vector<GameBoardPosition>(6));
-  board_.push_back(std::vector<GameBoardPosition>(7));
-  board_.push_back(std::vector<GameBoardPosition>(8));
-  board_.push_back(std::vector<GameBoardPosition>(8));
-  board_.push_back(std::vector<GameBoardPosition>(8));
-  board_.push_back(std::vector<GameBoardPosition>(7));
-  board_.push_back(std::vector<GameBoardPosition>(6));
-  board_.push_back(std::vector<GameBoardPosition>(5));
-
-  for (size_t col = 0; col < board_.size(); ++col) {
-    for (size_t row = 0; row < board_[col].size(); ++row) {
-      board_[col][row].set_col(col);
-      board_[col][row].set_row(row);
-    }
-  }
-
-  InitLinks();
+void GameBoard::AddPieces(wtc::Color color, wtpt::PieceType type,
+    int stack_height, int cell) {
+  int to_height = stack_height_[cell];
+  ClearPieces(cell);
+
+  color_mask_[color - 1] |= CellBit(cell);
+  type_mask_[type - 1] |= CellBit(cell);
+  stack_height_[cell] = static_cast<unsigned char>(to_height + stack_height);
 }
 
-void GameBoard::InitLinks() {
-  for (size_t col = 0; col < board_.size(); ++col) {
-    for (size_t row = 0; row < board_[col].size(); ++row) {
-      // Set up north links.
-      //
-      // A position has a north link UNLESS it is:
-      //  - the top piece of a column (row == max)
-      //  - directly south of the center position
-      //
-      if (row < board_[col].size() - 1 && !(col == 4 && row == 3))
-        board_[col][row].n(&board_[col][row + 1]);
-
-      // Set up northeast links.
-      //
-      // A position has a northeast link UNLESS it is:
-      //  - the top piece of a center or right-hand-side column (row == max)
-      //  - in the right-most column
-      //  - directly southwest of the center position
-      //
-      if (!(col > 3 && row == board_[col].size() - 1) &&
-          !(col == 8) &&
-          !(col == 3 && row == 3)) {
-        if (col < 3 || (col == 3 && row < 3) || (col == 4 && row > 3))
-          board_[col][row].ne(&board_[col + 1][row + 1]);
-        else
-          board_[col][row].ne(&board_[col + 1][row]);
-      }
-
-      // Set up southeast links.
-      //
-      // A position has a southeast link UNLESS it is:
-      //  - the bottom piece of a center or right-hand-side column (row == 0)
-      //  - in the right-most column
-      //  - directly northwest of the center position
-      //
-      if (!(col > 3 && row == 0) &&
-          !(col == 8) &&
-          !(col == 3 && row == 4)) {
-        if (col > 4 || (col == 3 && row > 4) || (col == 4 && row < 4))
-          board_[col][row].se(&board_[col + 1][row - 1]);
-        else
-          board_[col][row].se(&board_[col + 1][row]);
-      }
-
-      // Set up south links.
-      //
-      // A position has a south link UNLESS it is:
-      //  - the bottom piece of a column (row == 0)
-      //  - directly north of the center position
-      //
-      if (row > 0 && !(col == 4 && row == 4))
-        board_[col][row].s(&board_[col][row - 1]);
-
-      // Set up southwest links.
-      //
-      // A position has a southwest link UNLESS it is:
-      //  - the bottom piece of a center or left-hand-side column (row == 0)
-      //  - in the left-most column
-      //  - directly northeast of the center position
-      //
-      if (!(col < 5 && row == 0) &&
-          !(col == 0) &&
-          !(col == 5 && row == 4)) {
-        if (col < 4 || (col == 4 && row < 4) || (col == 5 && row > 4))
-          board_[col][row].sw(&board_[col - 1][row - 1]);
-        else
-          board_[col][row].sw(&board_[col - 1][row]);
-      }
-
-      // Set up northwest links.
-      //
-      // A position has a northwest link UNLESS it is:
-      //  - the top piece of a center or left-hand-side column (row == max)
-      //  - in the left-most column
-      //  - directly southeast of the center position
-      //
-      if (!(col < 5 && row == board_[col].size() - 1) &&
-          !(col == 0) &&
-          !(col == 5 && row == 3)) {
-        if (col > 5 || (col == 5 && row < 3) || (col == 4 && row > 3))
-          board_[col][row].nw(&board_[col - 1][row + 1]);
-        else
-          board_[col][row].nw(&board_[col - 1][row]);
-      }
-    }
-  }
+void GameBoard::AddPieces(wtc::Color color, wtpt::PieceType type,
+    int stack_height, int col, int row) {
+  AddPieces(color, type, stack_height, CalculateCell(col, row));
 }
 
-void GameBoard::AddPiece(wartzaar::types::color::Color color,
-    wartzaar::types::piecetype::PieceType type, int cell) {
-  board_[CalculateCol(cell)][CalculateRow(cell)].AddPieces(color, type, 1);
+void GameBoard::ClearPieces(int cell) {
+  uint64_t mask = ~CellBit(cell);
+
+  color_mask_[0] &= mask;
+  color_mask_[1] &= mask;
+  type_mask_[0] &= mask;
+  type_mask_[1] &= mask;
+  type_mask_[2] &= mask;
+  stack_height_[cell] = 0;
 }
 
-void GameBoard::AddPieces(wartzaar::types::color::Color color,
-    wartzaar::types::piecetype::PieceType type, int stack_height, int cell) {
-  board_[CalculateCol(cell)][CalculateRow(cell)].AddPieces(color, type, stack_height);
+GameBoardPosition GameBoard::PositionAt(int col, int row) const {
+  int cell = CalculateCell(col, row);
+
+  if (!IsOccupied(cell))
+    return GameBoardPosition(col, row);
+
+  return GameBoardPosition(col, row, ColorAt(cell), TypeAt(cell),
+      StackHeightAt(cell));
 }
 
-void GameBoard::AddPiece(wartzaar::types::color::Color color,
-    wartzaar::types::piecetype::PieceType type, int col, int row) {
-  board_[col][row].AddPieces(color, type, 1);
+bool GameBoard::IsOccupied(int cell) const {
+  return stack_height_[cell] != 0;
 }
 
-void GameBoard::AddPieces(wartzaar::types::color::Color color,
-    wartzaar::types::piecetype::PieceType type, int stack_height, int col, int row) {
-  board_[col][row].AddPieces(color, type, stack_height);
+wtc::Color GameBoard::ColorAt(int cell) const {
+  return (color_mask_[0] & CellBit(cell)) ? wtc::kWhite : wtc::kBlack;
 }
 
-GameBoardPosition* GameBoard::PositionAt(int col, int row) const {
-  return const_cast<GameBoardPosition*>(&board_[col][row]);
+wtpt::PieceType GameBoard::TypeAt(int cell) const {
+  if (type_mask_[wtpt::kTott - 1] & CellBit(cell))
+    return wtpt::kTott;
+  else if (type_mask_[wtpt::kTzarra - 1] & CellBit(cell))
+    return wtpt::kTzarra;
+  else
+    return wtpt::kTzaar;
 }
 
-int GameBoard::CalculateCell(int col, int row) const {
-  int cell;
-
-  switch (col) {
-    case 0:
-      cell = row;
-      break;
-    case 1:
-      cell = row + 5;
-      break;
-    case 2:
-      cell = row + 11;
-      break;
-    case 3:
-      cell = row + 18;
-      break;
-    case 4:
-      cell = row + 26;
-      break;
-    case 5:
-      cell = row + 36;
-      break;
-    case 6:
-      cell = row + 42;
-      break;
-    case 7:
-      cell = row + 49;
-      break;
-    case 8:
-      cell = row + 55;
-      break;
-    default:
-      throw std::runtime_error("Invalid column value");
-      break;
-  }
-
-  return cell;
+int GameBoard::StackHeightAt(int cell) const {
+  return stack_height_[cell];
 }
 
-int GameBoard::CalculateCol(int cell) const {
-  int column;
-
-  if (cell < 5)
-    column = 0;
-  else if (cell < 11)
-    column = 1;
-  else if (cell < 18)
-    column = 2;
-  else if (cell < 26)
-    column = 3;
-  else if (cell < 34)
-    column = 4;
-  else if (cell < 42)
-    column = 5;
-  else if (cell < 49)
-    column = 6;
-  else if (cell < 55)
-    column = 7;
-  else if (cell < 60)
-    column = 8;
-  else
-    throw std::runtime_error("Cell number must be between 0 and 59");
+uint64_t GameBoard::ColorMask(wtc::Color color) const {
+  return color_mask_[color - 1];
+}
+
+uint64_t GameBoard::TypeMask(wtpt::PieceType type) const {
+  return type_mask_[type - 1];
+}
 
-  return column;
+uint64_t GameBoard::OccupiedMask() const {
+  return color_mask_[0] | color_mask_[1];
 }
 
-int GameBoard::CalculateRow(int cell) const {
-  int row;
-  int col = CalculateCol(cell);
-
-  switch (col) {
-    case 0:
-      row = cell;
-      break;
-    case 1:
-      row = cell - 5;
-      break;
-    case 2:
-      row = cell - 11;
-      break;
-    case 3:
-      row = cell - 18;
-      break;
-    case 4:
-      row = cell - 26;
-      break;
-    case 5:
-      row = cell - 34;
-      break;
-    case 6:
-      row = cell - 42;
-      break;
-    case 7:
-      row = cell - 49;
-      break;
-    case 8:
-      row = cell - 55;
-      break;
-    default:
-      throw std::runtime_error("Cell number must be between 0 and 59");
-      break;
-  }
-
-  return row;
+/// Empty cells are skipped, so the search stops at the first stack or at the
+/// edge of the board. The first stack is found with a single bit scan of the
+/// occupied cells on the ray.
+///
+int GameBoard::SearchPath(int cell, wtd::Direction dir) const {
+  return BoardTopology::FirstBlocker(cell, dir, OccupiedMask());
 }
 
-std::vector< std::vector<GameBoardPosition> >::iterator GameBoard::Begin() {
-  return board_.begin();
+int GameBoard::Neighbor(int cell, wtd::Direction dir) {
+  if (BoardTopology::RayLength(cell, dir) == 0)
+    return kNoCell;
+
+  return BoardTopology::RayCell(cell, dir, 0);
 }
 
-std::vector< std::vector<GameBoardPosition> >::const_iterator GameBoard::BeginConst() const {
-  return board_.begin();
+int GameBoard::CalculateCell(int col, int row) {
+  if (col < 0 || col >= BoardTopology::kNumColumns)
+    throw std::runtime_error("Invalid column value");
+
+  return BoardTopology::Cell(col, row);
 }
 
-std::vector< std::vector<GameBoardPosition> >::iterator GameBoard::End() {
-  return board_.end();
+int GameBoard::CalculateCol(int cell) {
+  if (cell < 0 || cell >= kNumCells)
+    throw std::runtime_error("Cell number must be between 0 and 59");
+
+  return BoardTopology::Col(cell);
 }
 
-std::vector< std::vector<GameBoardPosition> >::const_iterator GameBoard::EndConst() const {
-  return board_.end();
+int GameBoard::CalculateRow(int cell) {
+  if (cell < 0 || cell >= kNumCells)
+    throw std::runtime_error("Cell number must be between 0 and 59");
+
+  return BoardTopology::Row(cell);
 }
 
 bool GameBoard::Equals(const GameBoard &that) const {
-  for (size_t col = 0; col < board_.size(); ++col)
-    for (size_t row = 0; row < board_[col].size(); ++row)
-      if (!board_[col][row].Equals(that.board_[col][row]))
-        return false;
-
-  return true;
+  return memcmp(color_mask_, that.color_mask_, sizeof(color_mask_)) == 0
+      && memcmp(type_mask_, that.type_mask_, sizeof(type_mask_)) == 0
+      && memcmp(stack_height_, that.stack_height_, sizeof(stack_height_)) == 0;
 }
 
 } // namespace wartzaar
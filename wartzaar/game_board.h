@@ -1,27 +1,36 @@
 #ifndef WARTZAAR_GAME_BOARD_H_
 #define WARTZAAR_GAME_BOARD_H_
 
-#include <vector>
+#include <stdint.h>
+
+#include "wartzaar/board_topology.h"
 #include "wartzaar/game_board_position.h"
 #include "wartzaar/types/color.h"
+#include "wartzaar/types/direction.h"
 #include "wartzaar/types/piece_type.h"
 
 namespace wartzaar {
 
 ///-----------------------------------------------------------------------------
+/// GameBoard is a bitboard representation of the 60-cell Tzaar board.
 ///
+/// Each cell is identified by its cell number (0-59), as calculated by
+/// CalculateCell, and occupies the bit of the same number in each mask. The
+/// board holds one occupancy mask per color, one per piece type, and the stack
+/// height of every cell. A board is a plain value and can be copied with a
+/// memcpy; the board geometry lives in BoardTopology and is shared by all
+/// boards.
 ///-----------------------------------------------------------------------------
 class GameBoard {
  public:
-  /// Constructor calls Init.
-  GameBoard();
+  /// The number of cells on the board.
+  static const int kNumCells = BoardTopology::kNumCells;
 
-  /// Copy constructor calls Init and replaces each game board position on the
-  /// existing board with the contents of the new board.
-  GameBoard(const GameBoard &that);
+  /// The value returned by the cell lookups when no cell exists.
+  static const int kNoCell = BoardTopology::kNoCell;
 
-  /// Assignment operator
-  GameBoard& operator= (const GameBoard &that);
+  /// Constructor creates an empty board.
+  GameBoard();
 
   /// Adds a single piece to the game board at the specified cell.
   void AddPiece(wartzaar::types::color::Color color,
@@ -32,6 +41,10 @@ class GameBoard {
       wartzaar::types::piecetype::PieceType type, int col, int row);
 
   /// Adds a stack of pieces to the game board at the specified cell.
+  ///
+  /// The new pieces are placed on top of any existing stack, so the color and
+  /// type of the cell become those of the new pieces.
+  ///
   void AddPieces(wartzaar::types::color::Color color,
       wartzaar::types::piecetype::PieceType type, int stack_height, int cell);
 
@@ -40,41 +53,62 @@ class GameBoard {
       wartzaar::types::piecetype::PieceType type, int stack_height, int col,
       int row);
 
-  GameBoardPosition* PositionAt(int col, int row) const;
+  /// Removes all pieces from the specified cell.
+  void ClearPieces(int cell);
+
+  /// Returns a copy of the contents of the cell at the given column and row.
+  GameBoardPosition PositionAt(int col, int row) const;
+
+  /// Returns true if there are one or more pieces in the given cell.
+  bool IsOccupied(int cell) const;
+
+  /// Returns the color of the stack in the given (occupied) cell.
+  wartzaar::types::color::Color ColorAt(int cell) const;
+
+  /// Returns the type of the top piece in the given (occupied) cell.
+  wartzaar::types::piecetype::PieceType TypeAt(int cell) const;
+
+  /// Returns the number of pieces in the given cell.
+  int StackHeightAt(int cell) const;
+
+  /// Returns the mask of all cells occupied by the given color.
+  uint64_t ColorMask(wartzaar::types::color::Color color) const;
+
+  /// Returns the mask of all cells topped by the given piece type.
+  uint64_t TypeMask(wartzaar::types::piecetype::PieceType type) const;
+
+  /// Returns the mask of all occupied cells.
+  uint64_t OccupiedMask() const;
+
+  /// Returns the first occupied cell in the given direction from the given
+  /// cell, or kNoCell if no stack can be reached in that direction.
+  int SearchPath(int cell, wartzaar::types::direction::Direction dir) const;
+
+  /// Returns the adjacent cell in the given direction, or kNoCell if the given
+  /// cell is on the edge of the board or next to the center.
+  static int Neighbor(int cell, wartzaar::types::direction::Direction dir);
 
   /// Calculates the cell number (0-59) for a given column and row.
-  int CalculateCell(int col, int row) const;
+  static int CalculateCell(int col, int row);
 
   /// Calculates the column number for a given cell number (0-59).
-  int CalculateCol(int cell) const;
+  static int CalculateCol(int cell);
 
   /// Calculates the row number for a given cell number (0-59).
-  int CalculateRow(int cell) const;
-
-  /// Returns a (const) iterator to the first element of the board vector.
-  std::vector< std::vector<GameBoardPosition> >::iterator Begin();
-  std::vector< std::vector<GameBoardPosition> >::const_iterator BeginConst() const;
-
-  /// Returns a (const) iterator to the end of the board vector.
-  std::vector< std::vector<GameBoardPosition> >::iterator End();
-  std::vector< std::vector<GameBoardPosition> >::const_iterator EndConst() const;
+  static int CalculateRow(int cell);
 
   /// Returns true if the given game board is equal to this game board.
   bool Equals(const GameBoard &that) const;
 
  private:
-  /// Initializes the board positions.
-  void Init();
+  /// Occupancy masks, indexed by color - 1.
+  uint64_t color_mask_[2];
 
-  /// Initializes the links between board positions.
-  void InitLinks();
+  /// Top-of-stack piece type masks, indexed by type - 1.
+  uint64_t type_mask_[3];
 
-  /// A 2-dimensional vector of GameBoardPositions representing the Tzaar board.
-  ///
-  /// The second dimension varies in size based on the number of positions in
-  /// that column on the board (a jagged vector).
-  ///
-  std::vector< std::vector<GameBoardPosition> > board_;
+  /// The number of pieces in each cell, indexed by cell number.
+  unsigned char stack_height_[kNumCells];
 };
 
 } // namespace wartzaar
@@ -2,7 +2,6 @@
 
 #include <stdexcept>
 
-namespace wtd = wartzaar::types::direction;
 namespace wtc = wartzaar::types::color;
 namespace wtpt = wartzaar::types::piecetype;
 
@@ -12,151 +11,42 @@ GameBoardPosition::GameBoardPosition()
     : col_(),
       row_(),
       stack_height_(0),
-      color_(0),
-      type_(0),
-      n_(0),
-      ne_(0),
-      se_(0),
-      s_(0),
-      sw_(0),
-      nw_(0) {}
+      contents_(kEmpty) {}
 
 GameBoardPosition::GameBoardPosition(int col, int row)
     : col_(col),
       row_(row),
       stack_height_(0),
-      color_(0),
-      type_(0),
-      n_(0),
-      ne_(0),
-      se_(0),
-      s_(0),
-      sw_(0),
-      nw_(0) {}
+      contents_(kEmpty) {}
 
 GameBoardPosition::GameBoardPosition(int col, int row, wtc::Color color,
     wtpt::PieceType type)
     : col_(col),
       row_(row),
       stack_height_(1),
-      color_(new wtc::Color(color)),
-      type_(new wtpt::PieceType(type)),
-      n_(0),
-      ne_(0),
-      se_(0),
-      s_(0),
-      sw_(0),
-      nw_(0) {}
+      contents_(Pack(color, type)) {}
 
 GameBoardPosition::GameBoardPosition(int col, int row, wartzaar::types::color::Color color,
     wartzaar::types::piecetype::PieceType type, int stack_height)
     : col_(col),
       row_(row),
       stack_height_(stack_height),
-      color_(new wtc::Color(color)),
-      type_(new wtpt::PieceType(type)),
-      n_(0),
-      ne_(0),
-      se_(0),
-      s_(0),
-      sw_(0),
-      nw_(0) {}
-
-GameBoardPosition::GameBoardPosition(const GameBoardPosition &that)
-    : col_(that.col_),
-      row_(that.row_),
-      stack_height_(that.stack_height_),
-      color_(0),
-      type_(0),
-      n_(that.n_),
-      ne_(that.ne_),
-      se_(that.se_),
-      s_(that.s_),
-      sw_(that.sw_),
-      nw_(that.nw_) {
-  if (that.color_ != 0)
-    color_ = new wtc::Color(*(that.color_));
-  if (that.type_ != 0)
-    type_ = new wtpt::PieceType(*(that.type_));
-}
-
-GameBoardPosition::~GameBoardPosition() {
-  ClearPieces();
-}
+      contents_(Pack(color, type)) {}
 
 void GameBoardPosition::AddPieces(wartzaar::types::color::Color color,
     wartzaar::types::piecetype::PieceType type, int stack_height) {
-  int to_height = stack_height_;
-  ClearPieces();
-  color_ = new wtc::Color(color);
-  type_ = new wtpt::PieceType(type);
-  stack_height_ = to_height + stack_height;
+  contents_ = Pack(color, type);
+  stack_height_ += stack_height;
 }
 
 void GameBoardPosition::ClearPieces() {
-  if (color_ != 0) {
-    delete color_;
-    color_ = 0;
-  }
-  if (type_ != 0) {
-    delete type_;
-    type_ = 0;
-  }
-
+  contents_ = kEmpty;
   stack_height_ = 0;
 }
 
-/// Returns a null pointer if no path to another stack exists in the given
-/// direction.
-///
-GameBoardPosition* GameBoardPosition::SearchPath(const wtd::Direction &dir) const {
-  GameBoardPosition *pos = DirLink(dir);
-
-  while (pos != 0) {
-    // Skip empty positions
-    if (pos->stack_height() == 0) {
-      pos = pos->DirLink(dir);
-      continue;
-    }
-
-    return pos;
-  }
-
-  return 0;
-}
-
-GameBoardPosition* GameBoardPosition::DirLink(const wtd::Direction &dir) const {
-  switch (dir) {
-    case wtd::kNorth:
-      return n_;
-      break;
-    case wtd::kNortheast:
-      return ne_;
-      break;
-    case wtd::kSoutheast:
-      return se_;
-      break;
-    case wtd::kSouth:
-      return s_;
-      break;
-    case wtd::kSouthwest:
-      return sw_;
-      break;
-    case wtd::kNorthwest:
-      return nw_;
-      break;
-  }
-
-  return 0;
-}
-
 bool GameBoardPosition::Equals(const GameBoardPosition &that) const {
-  if (col_ == that.col_ && row_ == that.row_ && stack_height_ == that.stack_height_)
-    if ((color_ == 0 && type_ == 0 && that.color_ == 0 && that.type_ == 0)
-        || (*color_ == *(that.color_) && *type_ == *(that.type_)))
-      return true;
-
-  return false;
+  return col_ == that.col_ && row_ == that.row_
+      && stack_height_ == that.stack_height_ && contents_ == that.contents_;
 }
 
 wtc::Color GameBoardPosition::ParseColor(const std::string &color_string) {
@@ -191,11 +81,11 @@ wtpt::PieceType GameBoardPosition::ParseType(const std::string &type_string) {
   return type;
 }
 
-std::string GameBoardPosition::ColorString() {
+std::string GameBoardPosition::ColorString() const {
   std::string color_string;
-  if (color_ == 0) return color_string;
+  if (IsEmpty()) return color_string;
 
-  switch (*color_) {
+  switch (color()) {
     case wtc::kWhite:
       color_string = "White";
       break;
@@ -207,11 +97,11 @@ std::string GameBoardPosition::ColorString() {
   return color_string;
 }
 
-std::string GameBoardPosition::TypeString() {
+std::string GameBoardPosition::TypeString() const {
   std::string type_string;
-  if (type_ == 0) return type_string;
+  if (IsEmpty()) return type_string;
 
-  switch (*type_) {
+  switch (type()) {
     case wtpt::kTott:
       type_string = "Tott";
       break;
@@ -250,75 +140,28 @@ void GameBoardPosition::set_stack_height(int stack_height) {
   stack_height_ = stack_height;
 }
 
-wtc::Color* GameBoardPosition::color() const {
-  return color_;
-}
-
-void GameBoardPosition::set_color(wtc::Color *color) {
-  delete color_;
-  color_ = 0;
-  if (color != 0)
-    color_ = new wtc::Color(*color);
-}
-
-wtpt::PieceType* GameBoardPosition::type() const {
-  return type_;
-}
-
-void GameBoardPosition::set_type(wtpt::PieceType *type) {
-  delete type_;
-  type_ = 0;
-  if (type != 0)
-    type_ = new wtpt::PieceType(*type);
-}
-
-GameBoardPosition* GameBoardPosition::n() {
-  return n_;
-}
-
-void GameBoardPosition::n(const GameBoardPosition *n) {
-  n_ = const_cast<GameBoardPosition*>(n);
-}
-
-GameBoardPosition* GameBoardPosition::ne() {
-  return ne_;
-}
-
-void GameBoardPosition::ne(const GameBoardPosition *ne) {
-  ne_ = const_cast<GameBoardPosition*>(ne);
-}
-
-GameBoardPosition* GameBoardPosition::se() {
-  return se_;
-}
-
-
-void GameBoardPosition::se(const GameBoardPosition *se) {
-  se_ = const_cast<GameBoardPosition*>(se);
-}
-
-GameBoardPosition* GameBoardPosition::s() {
-  return s_;
+bool GameBoardPosition::IsEmpty() const {
+  return contents_ == kEmpty;
 }
 
-void GameBoardPosition::s(const GameBoardPosition *s) {
-  s_ = const_cast<GameBoardPosition*>(s);
+wtc::Color GameBoardPosition::color() const {
+  return static_cast<wtc::Color>(contents_ >> 2);
 }
 
-GameBoardPosition* GameBoardPosition::sw() {
-  return sw_;
+void GameBoardPosition::set_color(wtc::Color color) {
+  contents_ = Pack(color, IsEmpty() ? wtpt::kTott : type());
 }
 
-void GameBoardPosition::sw(const GameBoardPosition *sw) {
-  sw_ = const_cast<GameBoardPosition*>(sw);
+wtpt::PieceType GameBoardPosition::type() const {
+  return static_cast<wtpt::PieceType>(contents_ & 3);
 }
 
-GameBoardPosition* GameBoardPosition::nw() {
-  return nw_;
+void GameBoardPosition::set_type(wtpt::PieceType type) {
+  contents_ = Pack(IsEmpty() ? wtc::kWhite : color(), type);
 }
 
-void GameBoardPosition::nw(const GameBoardPosition *nw) {
-  nw_ = const_cast<GameBoardPosition*>(nw);
+unsigned char GameBoardPosition::Pack(wtc::Color color, wtpt::PieceType type) {
+  return static_cast<unsigned char>((color << 2) | type);
 }
 
 } // namespace wartzaar
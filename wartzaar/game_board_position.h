@@ -4,7 +4,6 @@
 #include <string>
 
 #include "wartzaar/types/color.h"
-#include "wartzaar/types/direction.h"
 #include "wartzaar/types/piece_type.h"
 
 namespace wtc = wartzaar::types::color;
@@ -13,16 +12,18 @@ namespace wtpt = wartzaar::types::piecetype;
 namespace wartzaar {
 
 ///-----------------------------------------------------------------------------
+/// GameBoardPosition holds the contents of a single cell of the game board,
+/// along with the column and row of that cell.
 ///
+/// The contents are stored inline as a packed color and type byte, so a
+/// position is a plain value that can be copied without touching the heap. An
+/// empty position has a stack height of zero and no color or type.
 ///-----------------------------------------------------------------------------
 class GameBoardPosition {
  public:
   /// Default constructor.
   GameBoardPosition();
 
-  /// Destructor.
-  ~GameBoardPosition();
-
   /// Constructor initializes a position with a column and row.
   GameBoardPosition(int col, int row);
 
@@ -36,26 +37,21 @@ class GameBoardPosition {
   GameBoardPosition(int col, int row, wartzaar::types::color::Color color,
       wartzaar::types::piecetype::PieceType type, int stack_height);
 
-  /// Copy constructor
-  GameBoardPosition(const GameBoardPosition &that);
-
   void AddPieces(wartzaar::types::color::Color color,
       wartzaar::types::piecetype::PieceType type, int stack_height);
 
   void ClearPieces();
 
-  GameBoardPosition* SearchPath(const wartzaar::types::direction::Direction &dir) const;
-
-  /// Returns the pointer for the position in the given direction.
-  GameBoardPosition* DirLink(const wartzaar::types::direction::Direction &dir) const;
-
   /// Returns true if the given game board position is equal to this one.
   bool Equals(const GameBoardPosition &that) const;
 
   static wtc::Color ParseColor(const std::string &color_string);
   static wtpt::PieceType ParseType(const std::string &type_string);
-  std::string ColorString();
-  std::string TypeString();
+  std::string ColorString() const;
+  std::string TypeString() const;
+
+  /// Returns true if there are no pieces in this position.
+  bool IsEmpty() const;
 
   int col() const;
   void set_col(int col);
@@ -66,42 +62,29 @@ class GameBoardPosition {
   int stack_height() const;
   void set_stack_height(int stack_height);
 
-  wartzaar::types::color::Color* color() const;
-  void set_color(wartzaar::types::color::Color *color);
-
-  wartzaar::types::piecetype::PieceType* type() const;
-  void set_type(wartzaar::types::piecetype::PieceType *type);
+  /// The color and type of the top piece. These are only meaningful if the
+  /// position is not empty.
+  wartzaar::types::color::Color color() const;
+  void set_color(wartzaar::types::color::Color color);
 
-  GameBoardPosition* n();
-  void n(const GameBoardPosition *n);
+  wartzaar::types::piecetype::PieceType type() const;
+  void set_type(wartzaar::types::piecetype::PieceType type);
 
-  GameBoardPosition* ne();
-  void ne(const GameBoardPosition *ne);
-
-  GameBoardPosition* se();
-  void se(const GameBoardPosition *se);
-
-  GameBoardPosition* s();
-  void s(const GameBoardPosition *s);
+ private:
+  /// The value of contents_ for an empty position.
+  static const unsigned char kEmpty = 0;
 
-  GameBoardPosition* sw();
-  void sw(const GameBoardPosition *sw);
+  /// Packs a color and piece type into a single contents_ byte.
+  static unsigned char Pack(wartzaar::types::color::Color color,
+      wartzaar::types::piecetype::PieceType type);
 
-  GameBoardPosition* nw();
-  void nw(const GameBoardPosition *nw);
+  unsigned char col_;
+  unsigned char row_;
+  unsigned char stack_height_;
 
- private:
-  unsigned int col_;
-  unsigned int row_;
-  unsigned int stack_height_;
-  wartzaar::types::color::Color *color_;
-  wartzaar::types::piecetype::PieceType *type_;
-  GameBoardPosition *n_;
-  GameBoardPosition *ne_;
-  GameBoardPosition *se_;
-  GameBoardPosition *s_;
-  GameBoardPosition *sw_;
-  GameBoardPosition *nw_;
+  /// The color of the top piece in bits 2-3 and its type in bits 0-1, or
+  /// kEmpty.
+  unsigned char contents_;
 };
 
 } // namespace wartzaar
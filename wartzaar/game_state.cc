@@ -1,10 +1,16 @@
 #include "wartzaar/game_state.h"
 
+#include <string.h>  // for memset
+
 #include <iostream>
 #include <limits>
-#include <sstream>
+
+#include "wartzaar/bitboard.h"
+#include "wartzaar/board_topology.h"
+#include "wartzaar/zobrist.h"
 
 namespace wtc = wartzaar::types::color;
+namespace wtd = wartzaar::types::direction;
 namespace wtpt = wartzaar::types::piecetype;
 
 namespace wartzaar {
@@ -12,205 +18,311 @@ namespace wartzaar {
 GameState::GameState(const GameBoard &board)
     : board_(board),
       heuristic_value_(-std::numeric_limits<float>::max()),
-      last_move_from_(0),
-      last_move_to_(0) {
+      color_to_move_(wtc::kWhite),
+      capture_only_(true),
+      single_move_turn_(true),
+      hash_(0) {
   Init();
 }
 
-GameState::GameState(const GameState &that)
-    : board_(that.board_),
-      heuristic_value_(that.heuristic_value_),
-      last_move_from_(0),
-      last_move_to_(0),
-      stack_height_(that.stack_height_),
-      piece_count_(that.piece_count_) {
-  if (that.last_move_from_ != 0) {
-    last_move_from_ = board_.PositionAt(
-      that.last_move_from_->col(),
-      that.last_move_from_->row()
-    );
-  }
+bool GameState::operator==(const GameState &that) const {
+  return board_.Equals(that.board_);
+}
 
-  if (that.last_move_to_ != 0) {
-    last_move_to_ = board_.PositionAt(
-      that.last_move_to_->col(),
-      that.last_move_to_->row()
-    );
-  }
+bool GameState::operator<(const GameState &that) const {
+  return heuristic_value_ < that.heuristic_value_;
 }
 
-GameState &GameState::operator=(const GameState &that) {
-  board_ = that.board_;
-  heuristic_value_ = that.heuristic_value_;
-  stack_height_ = that.stack_height_;
-  piece_count_ = that.piece_count_;
+bool GameState::operator>(const GameState &that) const {
+  return heuristic_value_ > that.heuristic_value_;
+}
+
+void GameState::Init() {
+  memset(piece_count_, 0, sizeof(piece_count_));
+  memset(stack_height_, 0, sizeof(stack_height_));
+
+  for (int cell = 0; cell < GameBoard::kNumCells; ++cell) {
+    if (!board_.IsOccupied(cell))
+      continue;
 
-  if (that.last_move_from_ != 0) {
-    last_move_from_ = board_.PositionAt(
-      that.last_move_from_->col(),
-      that.last_move_from_->row()
-    );
+    wtc::Color color = board_.ColorAt(cell);
+    wtpt::PieceType type = board_.TypeAt(cell);
+
+    piece_count_[color - 1][type - 1]++;
+    stack_height_[color - 1][type - 1] += board_.StackHeightAt(cell) - 1;
   }
 
-  if (that.last_move_to_ != 0) {
-    last_move_to_ = board_.PositionAt(
-      that.last_move_to_->col(),
-      that.last_move_to_->row()
-    );
+  // Every pair of stacks that can reach each other lies on a line, so each
+  // pair is counted once by looking only north, northeast and southeast.
+  memset(capture_count_, 0, sizeof(capture_count_));
+  uint64_t occupied = board_.OccupiedMask();
+
+  for (uint64_t mask = occupied; mask != 0; ) {
+    int cell = PopLowestBit(mask);
+
+    for (int dir = wtd::kNorth; dir <= wtd::kSoutheast; ++dir) {
+      int blocker = BoardTopology::FirstBlocker(cell,
+          static_cast<wtd::Direction>(dir), occupied);
+      if (blocker != GameBoard::kNoCell)
+        CountCaptures(cell, blocker, 1);
+    }
   }
 
-  return *this;
+  hash_ = ComputeHash();
 }
 
-bool GameState::operator==(const GameState &that) const {
-  return board_.Equals(that.board_);
-}
+void GameState::CountCaptures(int a, int b, int sign) {
+  wtc::Color a_color = board_.ColorAt(a);
+  wtc::Color b_color = board_.ColorAt(b);
 
-bool GameState::operator<(const GameState &that) const {
-  return heuristic_value_ < that.heuristic_value_;
+  if (a_color == b_color)
+    return;
+
+  int a_height = board_.StackHeightAt(a);
+  int b_height = board_.StackHeightAt(b);
+
+  if (a_height >= b_height)
+    capture_count_[a_color - 1] += sign;
+  if (b_height >= a_height)
+    capture_count_[b_color - 1] += sign;
 }
 
-bool GameState::operator>(const GameState &that) const {
-  return heuristic_value_ > that.heuristic_value_;
+void GameState::CountCapturesAround(int cell, int sign, int skip_cell) {
+  uint64_t occupied = board_.OccupiedMask();
+
+  for (int dir = wtd::kNorth; dir <= wtd::kNorthwest; ++dir) {
+    int blocker = BoardTopology::FirstBlocker(cell,
+        static_cast<wtd::Direction>(dir), occupied);
+    if (blocker != GameBoard::kNoCell && blocker != skip_cell)
+      CountCaptures(cell, blocker, sign);
+  }
 }
 
-void GameState::Init() {
-  piece_count_[wtc::kWhite][wtpt::kTzaar]  = 0;
-  piece_count_[wtc::kWhite][wtpt::kTzarra] = 0;
-  piece_count_[wtc::kWhite][wtpt::kTott]   = 0;
-  piece_count_[wtc::kBlack][wtpt::kTzaar]  = 0;
-  piece_count_[wtc::kBlack][wtpt::kTzarra] = 0;
-  piece_count_[wtc::kBlack][wtpt::kTott]   = 0;
-
-  stack_height_[wtc::kWhite][wtpt::kTzaar]  = 0;
-  stack_height_[wtc::kWhite][wtpt::kTzarra] = 0;
-  stack_height_[wtc::kWhite][wtpt::kTott]   = 0;
-  stack_height_[wtc::kBlack][wtpt::kTzaar]  = 0;
-  stack_height_[wtc::kBlack][wtpt::kTzarra] = 0;
-  stack_height_[wtc::kBlack][wtpt::kTott]   = 0;
-
-  std::vector< std::vector<GameBoardPosition> >::iterator col_itr;
-  for (col_itr = board_.Begin(); col_itr != board_.End(); ++col_itr) {
-    std::vector<GameBoardPosition>::iterator row_itr;
-    for (row_itr = col_itr->begin(); row_itr != col_itr->end(); ++row_itr) {
-      if (row_itr->stack_height() == 0)
+int GameState::CountCapturesInvolving(int a, int b,
+    const wtc::Color &color) const {
+  uint64_t occupied = board_.OccupiedMask();
+  int count = 0;
+
+  const int cells[2] = {a, b};
+  for (int i = 0; i < 2; ++i) {
+    int cell = cells[i];
+    wtc::Color cell_color = board_.ColorAt(cell);
+    int cell_height = board_.StackHeightAt(cell);
+
+    for (int dir = wtd::kNorth; dir <= wtd::kNorthwest; ++dir) {
+      int blocker = BoardTopology::FirstBlocker(cell,
+          static_cast<wtd::Direction>(dir), occupied);
+
+      // The pair of a and b is counted from a only
+      if (blocker == GameBoard::kNoCell || (i == 1 && blocker == a))
         continue;
 
-      wtc::Color color = *row_itr->color();
-      wtpt::PieceType type = *row_itr->type();
+      wtc::Color blocker_color = board_.ColorAt(blocker);
+      if (blocker_color == cell_color)
+        continue;
 
-      piece_count_ [color][type]++;
-      stack_height_[color][type] += row_itr->stack_height() - 1;
+      int blocker_height = board_.StackHeightAt(blocker);
+      if (cell_color == color ? cell_height >= blocker_height
+                              : blocker_height >= cell_height)
+        ++count;
     }
   }
+
+  return count;
 }
 
 void GameState::MakeMove(int from_column, int from_row, int to_column, int to_row) {
-  GameBoardPosition *from_ptr = board_.PositionAt(from_column, from_row);
-  GameBoardPosition *to_ptr   = board_.PositionAt(to_column, to_row);
+  MakeMove(GameBoard::CalculateCell(from_column, from_row),
+           GameBoard::CalculateCell(to_column, to_row));
+}
+
+void GameState::MakeMove(int from_cell, int to_cell) {
+  wtc::Color from_color = board_.ColorAt(from_cell);
+  wtc::Color to_color = board_.ColorAt(to_cell);
 
-  wtc::Color from_color = *from_ptr->color();
-  wtc::Color to_color = *to_ptr->color();
+  wtpt::PieceType to_type = board_.TypeAt(to_cell);
+  wtpt::PieceType from_type = board_.TypeAt(from_cell);
 
-  wtpt::PieceType to_type = *to_ptr->type();
-  wtpt::PieceType from_type = *from_ptr->type();
+  int to_height = board_.StackHeightAt(to_cell);
+  int from_height = board_.StackHeightAt(from_cell);
 
-  int to_height = to_ptr->stack_height();
-  int from_height = from_ptr->stack_height();
+  // Hash out both stacks; the combined stack is hashed in below
+  hash_ ^= Zobrist::StackKey(from_cell, from_color, from_type, from_height)
+         ^ Zobrist::StackKey(to_cell, to_color, to_type, to_height);
+
+  // Take out the captures involving either stack. The two stacks reach each
+  // other, so their own pair is only taken out once.
+  CountCapturesAround(from_cell, -1, GameBoard::kNoCell);
+  CountCapturesAround(to_cell, -1, from_cell);
 
   // Make a stacking move if the "from" and "to" colors are equal
   if (from_color == to_color) {
-    board_.AddPieces(*from_ptr->color(), *from_ptr->type(),
-        from_ptr->stack_height(), to_column, to_row);
-    from_ptr->ClearPieces();
+    board_.AddPieces(from_color, from_type, from_height, to_cell);
+    board_.ClearPieces(from_cell);
 
     // Adjust the stack height counters
-    stack_height_[from_color][from_type]
-        += (board_.PositionAt(to_column, to_row)->stack_height() - 1) // combined height
-         - (from_height - 1);                                         // source height
+    stack_height_[from_color - 1][from_type - 1]
+        += (board_.StackHeightAt(to_cell) - 1) // combined height
+         - (from_height - 1);                  // source height
 
-    stack_height_[to_color][to_type] -= (to_height - 1);
+    stack_height_[to_color - 1][to_type - 1] -= (to_height - 1);
   }
   // Otherwise, make a capturing move
   else {
     // Adjust the stack height counter
-    stack_height_[to_color][to_type] -= (to_height - 1);
+    stack_height_[to_color - 1][to_type - 1] -= (to_height - 1);
 
-    to_ptr->ClearPieces();
-    to_ptr->AddPieces(*from_ptr->color(), *from_ptr->type(), from_ptr->stack_height());
-    from_ptr->ClearPieces();
+    board_.ClearPieces(to_cell);
+    board_.AddPieces(from_color, from_type, from_height, to_cell);
+    board_.ClearPieces(from_cell);
   }
 
   // Adjust the piece counters
-  piece_count_[to_color][to_type]--;
+  piece_count_[to_color - 1][to_type - 1]--;
 
-  // Update the last move pointers
-  last_move_from_ = from_ptr;
-  last_move_to_ = to_ptr;
-}
+  hash_ ^= Zobrist::StackKey(board_, to_cell);
 
-int GameState::GetStackHeight(const wtc::Color &color, const wtpt::PieceType &type) const {
-  return stack_height_.find(color)->second.find(type)->second;
-}
+  // Put back the captures involving the combined stack, and add those between
+  // the stacks on either side of the emptied cell, which now reach each other.
+  CountCapturesAround(to_cell, 1, GameBoard::kNoCell);
 
-int GameState::GetPieceCount(const wtc::Color &color, const wtpt::PieceType &type) const {
-  return piece_count_.find(color)->second.find(type)->second;
-}
+  uint64_t occupied = board_.OccupiedMask();
+  for (int dir = wtd::kNorth; dir <= wtd::kSoutheast; ++dir) {
+    int a = BoardTopology::FirstBlocker(from_cell,
+        static_cast<wtd::Direction>(dir), occupied);
+    int b = BoardTopology::FirstBlocker(from_cell,
+        static_cast<wtd::Direction>(dir + 3), occupied);
 
-std::vector< std::vector<GameBoardPosition> >::iterator GameState::Begin() {
-  return board_.Begin();
-}
+    if (a != GameBoard::kNoCell && b != GameBoard::kNoCell
+        && a != to_cell && b != to_cell)
+      CountCaptures(a, b, 1);
+  }
 
-std::vector< std::vector<GameBoardPosition> >::const_iterator GameState::BeginConst() const {
-  return board_.BeginConst();
+  AdvanceTurn();
 }
 
-std::vector< std::vector<GameBoardPosition> >::iterator GameState::End() {
-  return board_.End();
+/// The first move of a turn is followed by a second move by the same player,
+/// unless this is the single-move first turn of the game.
+///
+void GameState::AdvanceTurn() {
+  if (capture_only_ && !single_move_turn_) {
+    capture_only_ = false;
+    hash_ ^= Zobrist::SecondMoveKey();
+  }
+  else {
+    color_to_move_ = (color_to_move_ == wtc::kWhite) ? wtc::kBlack : wtc::kWhite;
+    hash_ ^= Zobrist::BlackToMoveKey();
+
+    if (!capture_only_) {
+      capture_only_ = true;
+      hash_ ^= Zobrist::SecondMoveKey();
+    }
+  }
+
+  single_move_turn_ = false;
 }
 
-std::vector< std::vector<GameBoardPosition> >::const_iterator GameState::EndConst() const {
-  return board_.EndConst();
+void GameState::MakeMove(const Move &move, UndoRecord &undo) {
+  undo.color_to_move    = color_to_move_;
+  undo.capture_only     = capture_only_;
+  undo.single_move_turn = single_move_turn_;
+  undo.hash             = hash_;
+  undo.capture_count[0] = capture_count_[0];
+  undo.capture_count[1] = capture_count_[1];
+
+  // A pass only hands on the turn
+  if (move.IsPass()) {
+    undo.from_cell = GameBoard::kNoCell;
+    undo.to_cell = GameBoard::kNoCell;
+    AdvanceTurn();
+    return;
+  }
+
+  undo.from_cell   = move.from_cell();
+  undo.from_color  = board_.ColorAt(undo.from_cell);
+  undo.from_type   = board_.TypeAt(undo.from_cell);
+  undo.from_height = board_.StackHeightAt(undo.from_cell);
+
+  undo.to_cell   = move.to_cell();
+  undo.to_color  = board_.ColorAt(undo.to_cell);
+  undo.to_type   = board_.TypeAt(undo.to_cell);
+  undo.to_height = board_.StackHeightAt(undo.to_cell);
+
+  MakeMove(undo.from_cell, undo.to_cell);
 }
 
-bool GameState::Equals(const GameState &that) {
-  return board_.Equals(that.board_);
+void GameState::UnmakeMove(const UndoRecord &undo) {
+  color_to_move_    = undo.color_to_move;
+  capture_only_     = undo.capture_only;
+  single_move_turn_ = undo.single_move_turn;
+  hash_             = undo.hash;
+  capture_count_[0] = undo.capture_count[0];
+  capture_count_[1] = undo.capture_count[1];
+
+  if (undo.from_cell == GameBoard::kNoCell)
+    return;
+
+  // Put both stacks back where they were
+  board_.ClearPieces(undo.to_cell);
+  board_.AddPieces(undo.to_color, undo.to_type, undo.to_height, undo.to_cell);
+  board_.AddPieces(undo.from_color, undo.from_type, undo.from_height,
+      undo.from_cell);
+
+  // Reverse the stack height counter adjustments made by MakeMove
+  if (undo.from_color == undo.to_color)
+    stack_height_[undo.from_color - 1][undo.from_type - 1] -= undo.to_height;
+
+  stack_height_[undo.to_color - 1][undo.to_type - 1] += undo.to_height - 1;
+
+  // Restore the piece counter
+  piece_count_[undo.to_color - 1][undo.to_type - 1]++;
 }
 
-std::string GameState::ToString() {
-  if (last_move_from_ == 0 || last_move_to_ == 0)
-    return std::string();
+const GameBoard& GameState::board() const {
+  return board_;
+}
 
-  std::stringstream s;
-  s << last_move_from_->col() << "," << last_move_from_->row()
-    << " -> "
-    << last_move_to_->col()   << "," << last_move_to_->row();
+void GameState::SetTurn(wtc::Color color_to_move, bool capture_only,
+    bool single_move_turn) {
+  color_to_move_ = color_to_move;
+  capture_only_ = capture_only;
+  single_move_turn_ = single_move_turn;
+  hash_ = ComputeHash();
+}
 
-  return s.str();
+wtc::Color GameState::color_to_move() const {
+  return color_to_move_;
 }
 
-float GameState::heuristic_value() const {
-  return heuristic_value_;
+bool GameState::capture_only() const {
+  return capture_only_;
 }
 
-void GameState::set_heuristic_value(float heuristic_value) {
-  heuristic_value_ = heuristic_value;
+uint64_t GameState::hash() const {
+  return hash_;
 }
 
-GameBoardPosition* GameState::last_move_from() {
-  return last_move_from_;
+uint64_t GameState::ComputeHash() const {
+  uint64_t hash = Zobrist::HashBoard(board_);
+
+  if (color_to_move_ == wtc::kBlack)
+    hash ^= Zobrist::BlackToMoveKey();
+  if (!capture_only_)
+    hash ^= Zobrist::SecondMoveKey();
+
+  return hash;
 }
 
-void GameState::set_last_move_from(const GameBoardPosition &position) {
-  last_move_from_ = const_cast<GameBoardPosition*>(&position);
+bool GameState::Equals(const GameState &that) {
+  return board_.Equals(that.board_);
 }
 
-GameBoardPosition* GameState::last_move_to() {
-  return last_move_to_;
+float GameState::heuristic_value() const {
+  return heuristic_value_;
 }
 
-void GameState::set_last_move_to(const GameBoardPosition &position) {
-  last_move_to_ = const_cast<GameBoardPosition*>(&position);
+void GameState::set_heuristic_value(float heuristic_value) {
+  heuristic_value_ = heuristic_value;
 }
 
 } // namespace wartzaar
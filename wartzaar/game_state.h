@@ -1,15 +1,39 @@
 #ifndef WARTZAAR_GAME_STATE_H_
 #define WARTZAAR_GAME_STATE_H_
 
-#include <map>
+#include <stdint.h>
+
 #include <string>
-#include <vector>
 
 #include "wartzaar/game_board.h"
 #include "wartzaar/game_state.h"
+#include "wartzaar/move.h"
 
 namespace wartzaar {
 
+///-----------------------------------------------------------------------------
+/// UndoRecord holds everything GameState::UnmakeMove needs to take back a move:
+/// the two stacks that were touched, the turn and the hash. A pass touches no
+/// stacks, and has kNoCell for both cells.
+///-----------------------------------------------------------------------------
+struct UndoRecord {
+  int from_cell;
+  wartzaar::types::color::Color from_color;
+  wartzaar::types::piecetype::PieceType from_type;
+  int from_height;
+
+  int to_cell;
+  wartzaar::types::color::Color to_color;
+  wartzaar::types::piecetype::PieceType to_type;
+  int to_height;
+
+  wartzaar::types::color::Color color_to_move;
+  bool capture_only;
+  bool single_move_turn;
+  uint64_t hash;
+  int capture_count[2];
+};
+
 ///-----------------------------------------------------------------------------
 ///
 ///-----------------------------------------------------------------------------
@@ -17,12 +41,6 @@ class GameState {
  public:
   GameState(const GameBoard &board);
 
-  /// Copy constructor
-  GameState(const GameState &that);
-
-  /// Assignment operator
-  GameState& operator=(const GameState &that);
-
   /// Equals operator
   bool operator==(const GameState &that) const;
 
@@ -34,19 +52,64 @@ class GameState {
 
   void MakeMove(int from_column, int from_row, int to_column, int to_row);
 
+  /// Moves the stack in the "from" cell onto the stack in the "to" cell,
+  /// capturing it if the colors differ and stacking on it otherwise.
+  void MakeMove(int from_cell, int to_cell);
+
+  /// Makes the given move in place and records in undo what is needed to take
+  /// it back with UnmakeMove. The move may be a pass.
+  void MakeMove(const Move &move, UndoRecord &undo);
+
+  /// Takes back the move recorded in undo. Moves must be taken back in the
+  /// reverse of the order they were made.
+  void UnmakeMove(const UndoRecord &undo);
+
   int GetStackHeight(const wartzaar::types::color::Color &color,
       const wartzaar::types::piecetype::PieceType &type) const;
 
   int GetPieceCount(const wartzaar::types::color::Color &color,
       const wartzaar::types::piecetype::PieceType &type) const;
 
-  /// Returns a (const) iterator to the first element of the board vector.
-  std::vector< std::vector<GameBoardPosition> >::iterator Begin();
-  std::vector< std::vector<GameBoardPosition> >::const_iterator BeginConst() const;
+  /// Returns the number of capturing moves the given color could make.
+  int GetCaptureCount(const wartzaar::types::color::Color &color) const;
+
+  /// Returns the number of capturing moves the given color could make that
+  /// involve the stack in cell a or the stack in cell b. A move between the
+  /// two stacks takes away at most this many of the color's captures.
+  int CountCapturesInvolving(int a, int b,
+      const wartzaar::types::color::Color &color) const;
+
+  /// The most captures of one color that can involve the stacks in two
+  /// cells. Each stack reaches at most one stack in each of the six
+  /// directions, and the two stacks' own pair is counted once.
+  static const int kMaxCapturesInvolving = 11;
+
+  /// Returns the game board representing this state.
+  const GameBoard& board() const;
+
+  /// Sets whose turn it is.
+  ///
+  /// On the first move of a turn only capturing moves are allowed
+  /// (capture_only); the second move may capture or stack. The very first
+  /// turn of the game is a single capturing move (single_move_turn). After
+  /// that, MakeMove advances the turn by itself.
+  ///
+  void SetTurn(wartzaar::types::color::Color color_to_move, bool capture_only,
+      bool single_move_turn);
+
+  /// The player who makes the next move.
+  wartzaar::types::color::Color color_to_move() const;
+
+  /// True if the next move is the first (capturing) move of a turn.
+  bool capture_only() const;
 
-  /// Returns a (const) iterator to the end of the board vector.
-  std::vector< std::vector<GameBoardPosition> >::iterator End();
-  std::vector< std::vector<GameBoardPosition> >::const_iterator EndConst() const;
+  /// Returns the 64-bit Zobrist key of this state, covering the board, the
+  /// player to move and the move within the turn.
+  uint64_t hash() const;
+
+  /// Computes the Zobrist key from scratch. This always equals hash(), which
+  /// is maintained incrementally.
+  uint64_t ComputeHash() const;
 
   /// Returns true if the given game state is equal to this game state.
   ///
@@ -55,49 +118,76 @@ class GameState {
   ///
   bool Equals(const GameState &that);
 
-  /// Prints the move that generated this state.
-  std::string ToString();
-
   float heuristic_value() const;
   void set_heuristic_value(float heuristic_value);
 
-  GameBoardPosition* last_move_from();
-  void set_last_move_from(const GameBoardPosition &last_move_from);
-
-  GameBoardPosition* last_move_to();
-  void set_last_move_to(const GameBoardPosition &last_move_to);
-
  private:
   void Init();
 
+  /// Hands the turn on after a move: from the first move of a turn to the
+  /// second, and from the second to the other player's first.
+  void AdvanceTurn();
+
+  /// Adds sign to the capture counts for the captures between the stacks in
+  /// cells a and b, which must be able to reach each other.
+  void CountCaptures(int a, int b, int sign);
+
+  /// Adds sign to the capture counts for the captures between the stack in
+  /// the given cell and every stack it can reach, except skip_cell.
+  void CountCapturesAround(int cell, int sign, int skip_cell);
+
   /// The game board representing the game state.
   GameBoard board_;
 
   /// The heuristic estimate of this state.
   float heuristic_value_;
 
-  GameBoardPosition *last_move_from_;
-  GameBoardPosition *last_move_to_;
+  wartzaar::types::color::Color color_to_move_;
+  bool capture_only_;
+  bool single_move_turn_;
+
+  /// The Zobrist key of this state, updated by every move.
+  uint64_t hash_;
 
   /// The adjusted stack height for each piece of each color. Only stacks of 2
   /// or more pieces are considered in this value. The first dimension is the
   /// player color, and the second dimension is the piece type.
   ///
-  /// height = map[color][type]
+  /// height = stack_height_[color - 1][type - 1]
   ///
-  std::map<wartzaar::types::color::Color,
-      std::map<wartzaar::types::piecetype::PieceType, int> > stack_height_;
+  int stack_height_[2][3];
 
-  /// A 2-dimensional map representing the number of pieces of each type for
-  /// each player. The first dimension is the player color, and the second
-  /// dimension is the piece type.
+  /// A 2-dimensional array holding the number of pieces of each type for each
+  /// player. The first dimension is the player color, and the second dimension
+  /// is the piece type.
   ///
-  /// count = map[color][type]
+  /// count = piece_count_[color - 1][type - 1]
   ///
-  std::map<wartzaar::types::color::Color,
-    std::map<wartzaar::types::piecetype::PieceType, int> > piece_count_;
+  int piece_count_[2][3];
+
+  /// The number of capturing moves available to each color, indexed by
+  /// color - 1. MakeMove only updates the captures along the rays through the
+  /// two cells it touches.
+  int capture_count_[2];
 };
 
+inline int GameState::GetStackHeight(
+    const wartzaar::types::color::Color &color,
+    const wartzaar::types::piecetype::PieceType &type) const {
+  return stack_height_[color - 1][type - 1];
+}
+
+inline int GameState::GetPieceCount(
+    const wartzaar::types::color::Color &color,
+    const wartzaar::types::piecetype::PieceType &type) const {
+  return piece_count_[color - 1][type - 1];
+}
+
+inline int GameState::GetCaptureCount(
+    const wartzaar::types::color::Color &color) const {
+  return capture_count_[color - 1];
+}
+
 } // namespace wartzaar
 
 #endif // WARTZAAR_GAME_STATE_H_
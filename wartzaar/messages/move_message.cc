@@ -2,6 +2,8 @@
 
 #include <sstream>
 
+#include "wartzaar/game_board.h"
+
 namespace wartzaar { namespace messages {
 
 MoveMessage::MoveMessage()
@@ -10,7 +12,9 @@ MoveMessage::MoveMessage()
       from_column_(-1),
       from_row_(-1),
       to_column_(-1),
-      to_row_(-1) {}
+      to_row_(-1) {
+  CreateText();
+}
 
 MoveMessage::MoveMessage(const std::string &message)
     : GameMessage(message, GameMessage::kMove),
@@ -32,9 +36,25 @@ MoveMessage::MoveMessage(int from_column, int from_row, int to_column, int to_ro
   CreateText();
 }
 
+MoveMessage::MoveMessage(const wartzaar::Move &move)
+    : GameMessage("Move{}", GameMessage::kMove),
+      pass_(false),
+      from_column_(GameBoard::CalculateCol(move.from_cell())),
+      from_row_(GameBoard::CalculateRow(move.from_cell())),
+      to_column_(GameBoard::CalculateCol(move.to_cell())),
+      to_row_(GameBoard::CalculateRow(move.to_cell())) {
+  CreateText();
+}
+
 // Extract the character for each move coordinate and convert it to an int.
+// An empty payload is a pass.
 //
 void MoveMessage::ParsePayload() {
+  if (payload_.empty()) {
+    pass_ = true;
+    return;
+  }
+
   std::stringstream ss(payload_);
 
   ss >> from_column_;
@@ -69,6 +89,14 @@ void MoveMessage::CreateText() {
   text_ = "Move{" + payload_ + "}\r\n";
 }
 
+bool MoveMessage::pass() const {
+  return pass_;
+}
+
+void MoveMessage::set_pass(bool pass) {
+  pass_ = pass;
+}
+
 int MoveMessage::from_column() const {
   return from_column_;
 }
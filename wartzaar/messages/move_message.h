@@ -2,6 +2,7 @@
 #define WARTZAAR_MESSAGES_MOVE_MESSAGE_H_
 
 #include "wartzaar/messages/game_message.h"
+#include "wartzaar/move.h"
 
 namespace wartzaar { namespace messages {
 
@@ -21,6 +22,9 @@ class MoveMessage : public GameMessage {
   /// Constructor creates a move message based on the given coordinates.
   MoveMessage(int from_column, int from_row, int to_column, int to_row);
 
+  /// Constructor creates a move message for the given move.
+  explicit MoveMessage(const wartzaar::Move &move);
+
   void ParsePayload();
   void CreatePayload();
   void CreateText();
@@ -0,0 +1,25 @@
+#include "wartzaar/move.h"
+
+#include <sstream>
+
+#include "wartzaar/game_board.h"
+
+namespace wartzaar {
+
+std::string Move::ToString() const {
+  if (IsNull())
+    return std::string();
+  if (IsPass())
+    return "pass";
+
+  std::stringstream s;
+  s << GameBoard::CalculateCol(from_cell()) << ","
+    << GameBoard::CalculateRow(from_cell())
+    << " -> "
+    << GameBoard::CalculateCol(to_cell()) << ","
+    << GameBoard::CalculateRow(to_cell());
+
+  return s.str();
+}
+
+} // namespace wartzaar
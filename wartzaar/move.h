@@ -0,0 +1,196 @@
+#ifndef WARTZAAR_MOVE_H_
+#define WARTZAAR_MOVE_H_
+
+#include <stdint.h>
+
+#include <string>
+
+namespace wartzaar {
+
+///-----------------------------------------------------------------------------
+/// Move is a single move packed into 16 bits.
+///
+/// Bits 0-5 hold the "from" cell, bits 6-11 the "to" cell, and bit 12 is set
+/// for a capturing move and clear for a stacking move. The all-zero value is
+/// the null move, which is never legal because a stack can't move onto itself.
+/// The pass move has both cells past the end of the board.
+///-----------------------------------------------------------------------------
+class Move {
+ public:
+  /// Constructor creates the null move.
+  Move();
+
+  /// Constructor creates a capturing or stacking move between two cells.
+  Move(int from_cell, int to_cell, bool capture);
+
+  /// Returns the move with the given packed value.
+  static Move FromValue(uint16_t value);
+
+  /// Returns the pass move, which gives up the second move of a turn.
+  static Move Pass();
+
+  /// Returns true if this is the null move.
+  bool IsNull() const;
+
+  /// Returns true if this is the pass move.
+  bool IsPass() const;
+
+  int from_cell() const;
+  int to_cell() const;
+
+  /// Returns true for a capturing move, false for a stacking or pass move.
+  bool capture() const;
+
+  /// Returns the packed 16-bit value of the move.
+  uint16_t value() const;
+
+  bool operator==(const Move &that) const;
+  bool operator!=(const Move &that) const;
+
+  /// Prints the move as "col,row -> col,row", or "pass".
+  std::string ToString() const;
+
+ private:
+  static const uint16_t kCellMask   = 0x3f;
+  static const int      kToShift    = 6;
+  static const uint16_t kCaptureBit = 0x1000;
+  static const uint16_t kPassValue  = kCellMask | (kCellMask << kToShift);
+
+  uint16_t value_;
+};
+
+///-----------------------------------------------------------------------------
+/// MoveList is a fixed-capacity list of moves, meant to live on the stack.
+///
+/// A side can't have more than one move per stack and direction, and it can't
+/// have more than 30 stacks, so kMaxMoves bounds the moves of any position,
+/// with room for a pass.
+///-----------------------------------------------------------------------------
+class MoveList {
+ public:
+  static const int kMaxMoves = 30 * 6 + 1;
+
+  MoveList();
+
+  /// Appends a move to the end of the list.
+  void Add(const Move &move);
+
+  /// Removes all moves from the list.
+  void Clear();
+
+  /// Returns the number of moves in the list.
+  int size() const;
+
+  /// Returns true if the list holds no moves.
+  bool empty() const;
+
+  const Move& operator[](int index) const;
+  Move& operator[](int index);
+
+  /// Returns pointers to the first and one-past-the-last moves.
+  const Move* begin() const;
+  const Move* end() const;
+  Move* begin();
+  Move* end();
+
+ private:
+  Move moves_[kMaxMoves];
+  int size_;
+};
+
+inline Move::Move()
+    : value_(0) {}
+
+inline Move::Move(int from_cell, int to_cell, bool capture)
+    : value_(static_cast<uint16_t>(from_cell
+                                   | (to_cell << kToShift)
+                                   | (capture ? kCaptureBit : 0))) {}
+
+inline Move Move::FromValue(uint16_t value) {
+  Move move;
+  move.value_ = value;
+  return move;
+}
+
+inline Move Move::Pass() {
+  return FromValue(kPassValue);
+}
+
+inline bool Move::IsNull() const {
+  return value_ == 0;
+}
+
+inline bool Move::IsPass() const {
+  return value_ == kPassValue;
+}
+
+inline int Move::from_cell() const {
+  return value_ & kCellMask;
+}
+
+inline int Move::to_cell() const {
+  return (value_ >> kToShift) & kCellMask;
+}
+
+inline bool Move::capture() const {
+  return (value_ & kCaptureBit) != 0;
+}
+
+inline uint16_t Move::value() const {
+  return value_;
+}
+
+inline bool Move::operator==(const Move &that) const {
+  return value_ == that.value_;
+}
+
+inline bool Move::operator!=(const Move &that) const {
+  return value_ != that.value_;
+}
+
+inline MoveList::MoveList()
+    : size_(0) {}
+
+inline void MoveList::Add(const Move &move) {
+  moves_[size_++] = move;
+}
+
+inline void MoveList::Clear() {
+  size_ = 0;
+}
+
+inline int MoveList::size() const {
+  return size_;
+}
+
+inline bool MoveList::empty() const {
+  return size_ == 0;
+}
+
+inline const Move& MoveList::operator[](int index) const {
+  return moves_[index];
+}
+
+inline Move& MoveList::operator[](int index) {
+  return moves_[index];
+}
+
+inline const Move* MoveList::begin() const {
+  return moves_;
+}
+
+inline const Move* MoveList::end() const {
+  return moves_ + size_;
+}
+
+inline Move* MoveList::begin() {
+  return moves_;
+}
+
+inline Move* MoveList::end() {
+  return moves_ + size_;
+}
+
+} // namespace wartzaar
+
+#endif // WARTZAAR_MOVE_H_
@@ -0,0 +1,105 @@
+#include "wartzaar/move_generator.h"
+
+#include "wartzaar/bitboard.h"
+#include "wartzaar/board_topology.h"
+
+namespace wtc = wartzaar::types::color;
+namespace wtd = wartzaar::types::direction;
+
+namespace wartzaar {
+
+/// A capturing move can be made in a given direction if:
+///   - There is a stack somewhere in that direction
+///   - The first such stack belongs to the opponent
+///   - The size of that stack is equal to or smaller than ours
+///
+/// A stacking move can be made in a given direction if:
+///   - There is a stack somewhere in that direction
+///   - The first such stack belongs to us
+///   - There are at least 2 of the destination piece type left on the board
+///
+void MoveGenerator::GenerateMoves(const GameState &state, wtc::Color color,
+    bool capture_only, MoveList &moves) {
+  moves.Clear();
+  const GameBoard &board = state.board();
+  uint64_t own_mask = board.ColorMask(color);
+  uint64_t occupied = board.OccupiedMask();
+
+  // Visit only the cells holding our own stacks
+  while (own_mask != 0) {
+    int cell = PopLowestBit(own_mask);
+
+    // Search for possible moves in each direction
+    for (int dir = wtd::kNorth; dir <= wtd::kNorthwest; ++dir) {
+      int pos = BoardTopology::FirstBlocker(cell,
+          static_cast<wtd::Direction>(dir), occupied);
+      if (pos == BoardTopology::kNoCell)
+        continue;
+
+      // Check for capturing move
+      if (color != board.ColorAt(pos)
+          && board.StackHeightAt(cell) >= board.StackHeightAt(pos))
+        moves.Add(Move(cell, pos, true));
+
+      // Check for stacking move
+      if (board.ColorAt(pos) == color && capture_only == false
+          && state.GetPieceCount(color, board.TypeAt(pos)) > 1)
+        moves.Add(Move(cell, pos, false));
+    }
+  }
+}
+
+int MoveGenerator::CountMoves(const GameState &state, wtc::Color color,
+    bool capture_only) {
+  int count = 0;
+  const GameBoard &board = state.board();
+  uint64_t own_mask = board.ColorMask(color);
+  uint64_t occupied = board.OccupiedMask();
+
+  while (own_mask != 0) {
+    int cell = PopLowestBit(own_mask);
+
+    for (int dir = wtd::kNorth; dir <= wtd::kNorthwest; ++dir) {
+      int pos = BoardTopology::FirstBlocker(cell,
+          static_cast<wtd::Direction>(dir), occupied);
+      if (pos == BoardTopology::kNoCell)
+        continue;
+
+      if (color != board.ColorAt(pos)
+          && board.StackHeightAt(cell) >= board.StackHeightAt(pos))
+        ++count;
+
+      if (board.ColorAt(pos) == color && capture_only == false
+          && state.GetPieceCount(color, board.TypeAt(pos)) > 1)
+        ++count;
+    }
+  }
+
+  return count;
+}
+
+bool MoveGenerator::HasCapture(const GameState &state, wtc::Color color) {
+  const GameBoard &board = state.board();
+  uint64_t own_mask = board.ColorMask(color);
+  uint64_t opponent_mask = board.OccupiedMask() & ~own_mask;
+  uint64_t occupied = board.OccupiedMask();
+
+  while (own_mask != 0) {
+    int cell = PopLowestBit(own_mask);
+    int height = board.StackHeightAt(cell);
+
+    for (int dir = wtd::kNorth; dir <= wtd::kNorthwest; ++dir) {
+      int pos = BoardTopology::FirstBlocker(cell,
+          static_cast<wtd::Direction>(dir), occupied);
+
+      if (pos != BoardTopology::kNoCell
+          && (opponent_mask & (static_cast<uint64_t>(1) << pos)) != 0
+          && height >= board.StackHeightAt(pos))
+        return true;
+    }
+  }
+
+  return false;
+}
+
+} // namespace wartzaar
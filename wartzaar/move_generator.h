@@ -0,0 +1,37 @@
+#ifndef WARTZAAR_MOVE_GENERATOR_H_
+#define WARTZAAR_MOVE_GENERATOR_H_
+
+#include "wartzaar/game_state.h"
+#include "wartzaar/move.h"
+#include "wartzaar/types/color.h"
+
+namespace wartzaar {
+
+///-----------------------------------------------------------------------------
+/// MoveGenerator finds the moves that can be made from a game state.
+///
+/// A stack can move along any of the six directions to the first stack in its
+/// way. It captures that stack if it belongs to the opponent and is no taller,
+/// and it stacks on it if it belongs to the same player, unless it would cover
+/// the last piece of a type. Stacking moves are not allowed on the first move
+/// of a turn (capture_only).
+///-----------------------------------------------------------------------------
+class MoveGenerator {
+ public:
+  /// Fills moves with the moves the given color can make from the given state.
+  static void GenerateMoves(const GameState &state,
+      wartzaar::types::color::Color color, bool capture_only, MoveList &moves);
+
+  /// Returns the number of moves GenerateMoves would find.
+  static int CountMoves(const GameState &state,
+      wartzaar::types::color::Color color, bool capture_only);
+
+  /// Returns true if the given color can make at least one capturing move.
+  /// This stops at the first capture found.
+  static bool HasCapture(const GameState &state,
+      wartzaar::types::color::Color color);
+};
+
+} // namespace wartzaar
+
+#endif // WARTZAAR_MOVE_GENERATOR_H_
@@ -0,0 +1,89 @@
+#include "wartzaar/perft.h"
+
+#include <time.h>  // for clock, CLOCKS_PER_SEC
+
+#include <iomanip>
+#include <ostream>
+#include <stdexcept>
+
+#include "wartzaar/move_generator.h"
+
+namespace wartzaar {
+
+/// One stack per cell, in cell number order.
+const char Perft::kStandardOpening[] =
+    "BoardState{"
+    "{WHITE,Tott},{BLACK,Tott},{WHITE,Tott},{BLACK,Tott},{WHITE,Tott},"
+    "{BLACK,Tott},{WHITE,Tott},{BLACK,Tzarra},{WHITE,Tzarra},{BLACK,Tott},"
+    "{BLACK,Tott},{WHITE,Tott},{BLACK,Tzarra},{WHITE,Tzaar},{BLACK,Tzaar},"
+    "{WHITE,Tzarra},{WHITE,Tzarra},{WHITE,Tott},{BLACK,Tott},{WHITE,Tzarra},"
+    "{BLACK,Tzarra},{WHITE,Tzaar},{BLACK,Tzaar},{BLACK,Tzarra},{BLACK,Tzarra},"
+    "{BLACK,Tott},{WHITE,Tott},{BLACK,Tott},{WHITE,Tzarra},{BLACK,Tzaar},"
+    "{WHITE,Tzaar},{WHITE,Tzaar},{WHITE,Tott},{WHITE,Tott},{BLACK,Tott},"
+    "{WHITE,Tzarra},{BLACK,Tzaar},{WHITE,Tzaar},{BLACK,Tzaar},{BLACK,Tzaar},"
+    "{BLACK,Tzarra},{BLACK,Tott},{WHITE,Tott},{BLACK,Tzarra},{WHITE,Tzaar},"
+    "{BLACK,Tzarra},{WHITE,Tzarra},{WHITE,Tzarra},{WHITE,Tott},{BLACK,Tott},"
+    "{WHITE,Tott},{BLACK,Tzarra},{WHITE,Tzarra},{BLACK,Tott},{BLACK,Tott},"
+    "{WHITE,Tott},{BLACK,Tott},{WHITE,Tott},{BLACK,Tott},{WHITE,Tott}"
+    "}";
+
+Perft::Perft(const GameState &state)
+    : state_(state) {}
+
+void Perft::Run(int max_depth, std::ostream &out) {
+  uint64_t hash = state_.hash();
+  GameBoard board = state_.board();
+  clock_t start = clock();
+
+  for (int depth = 1; depth <= max_depth; ++depth) {
+    clock_t depth_start = clock();
+    uint64_t leaves = Count(state_, depth);
+    double seconds =
+        static_cast<double>(clock() - depth_start) / CLOCKS_PER_SEC;
+
+    if (state_.hash() != hash || !state_.board().Equals(board))
+      throw std::runtime_error("Perft: state not restored after unmake");
+
+    out << "perft " << depth << ": " << leaves << " leaves in "
+        << std::fixed << std::setprecision(3) << seconds << " s";
+    if (seconds > 0)
+      out << " (" << std::setprecision(0) << leaves / seconds << " nodes/sec)";
+    out << std::endl;
+  }
+
+  out << "Total time: " << std::fixed << std::setprecision(3)
+      << static_cast<double>(clock() - start) / CLOCKS_PER_SEC << " s"
+      << std::endl;
+}
+
+/// At the last ply the moves are only counted, not made, since the leaves
+/// themselves are never looked at. The second move of a turn may be passed,
+/// so a pass is counted as one more move there.
+///
+uint64_t Perft::Count(GameState &state, int depth) {
+  if (depth == 0)
+    return 1;
+
+  if (depth == 1)
+    return MoveGenerator::CountMoves(state, state.color_to_move(),
+        state.capture_only()) + (state.capture_only() ? 0 : 1);
+
+  MoveList moves;
+  MoveGenerator::GenerateMoves(state, state.color_to_move(),
+      state.capture_only(), moves);
+  if (!state.capture_only())
+    moves.Add(Move::Pass());
+
+  uint64_t leaves = 0;
+  UndoRecord undo;
+
+  for (int i = 0; i < moves.size(); ++i) {
+    state.MakeMove(moves[i], undo);
+    leaves += Count(state, depth - 1);
+    state.UnmakeMove(undo);
+  }
+
+  return leaves;
+}
+
+} // namespace wartzaar
@@ -0,0 +1,49 @@
+#ifndef WARTZAAR_PERFT_H_
+#define WARTZAAR_PERFT_H_
+
+#include <stdint.h>
+
+#include <iosfwd>
+#include <string>
+
+#include "wartzaar/game_state.h"
+
+namespace wartzaar {
+
+///-----------------------------------------------------------------------------
+/// Perft counts the move sequences that can be played from a game state, down
+/// to a fixed depth.
+///
+/// Every move made by GameState::MakeMove is counted as one ply, so the turn
+/// structure (a capture, then a capture, a stack or a pass) is followed
+/// exactly as in the search. The leaf counts of a position never change, so they check the
+/// move generator and make/unmake whenever the board code is changed, and the
+/// time taken measures their speed.
+///-----------------------------------------------------------------------------
+class Perft {
+ public:
+  /// The standard opening position, as a BoardState message.
+  static const char kStandardOpening[];
+
+  /// Constructor takes the state to count from, with the turn already set.
+  explicit Perft(const GameState &state);
+
+  /// Counts the leaves at each depth from 1 through max_depth, writing the
+  /// count, time and speed of each depth to out.
+  ///
+  /// Throws std::runtime_error if the state is not restored exactly after a
+  /// depth has been counted.
+  ///
+  void Run(int max_depth, std::ostream &out);
+
+  /// Returns the number of move sequences of the given depth from the state.
+  /// The state is restored before returning.
+  static uint64_t Count(GameState &state, int depth);
+
+ private:
+  GameState state_;
+};
+
+} // namespace wartzaar
+
+#endif // WARTZAAR_PERFT_H_
@@ -0,0 +1,145 @@
+#include "wartzaar/search_stats.h"
+
+#include <iomanip>
+#include <ostream>
+
+namespace wartzaar {
+
+namespace {
+
+/// Returns the given duration in milliseconds.
+double Milliseconds(Clock::duration duration) {
+  return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+/// Returns part / whole, or zero if whole is zero.
+double Ratio(uint64_t part, uint64_t whole) {
+  return whole > 0 ? static_cast<double>(part) / whole : 0.0;
+}
+
+} // namespace
+
+SearchStats::SearchStats() {
+  Clear();
+}
+
+void SearchStats::Clear() {
+  evaluations = 0;
+  win_checks = 0;
+  tt_probes = 0;
+  tt_hits = 0;
+  tt_cutoffs = 0;
+  cutoffs = 0;
+  first_move_cutoffs = 0;
+  iterations = 0;
+
+  for (int depth = 0; depth <= kMaxDepth; ++depth) {
+    iteration_nodes[depth] = 0;
+    iteration_time[depth] = Clock::duration(0);
+  }
+}
+
+void SearchStats::Add(const SearchStats &that) {
+  evaluations += that.evaluations;
+  win_checks += that.win_checks;
+  tt_probes += that.tt_probes;
+  tt_hits += that.tt_hits;
+  tt_cutoffs += that.tt_cutoffs;
+  cutoffs += that.cutoffs;
+  first_move_cutoffs += that.first_move_cutoffs;
+}
+
+void SearchStats::RecordIteration(int depth, uint64_t nodes,
+    Clock::duration elapsed) {
+  if (depth < 1 || depth > kMaxDepth)
+    return;
+
+  iterations = depth;
+  iteration_nodes[depth] = nodes;
+  iteration_time[depth] = elapsed;
+}
+
+/// The nodes and time of an iteration are those it took itself, not the
+/// totals when it ended. The effective branching factor of an iteration is
+/// the ratio of the nodes it searched to the nodes the iteration before it
+/// searched.
+///
+void SearchStats::WriteJson(std::ostream &out, uint64_t nodes,
+    uint64_t qsearch_nodes, Clock::duration elapsed,
+    Clock::duration time_to_deadline) const {
+  std::ios::fmtflags flags = out.flags();
+  std::streamsize precision = out.precision();
+
+  out << std::fixed << std::setprecision(3)
+      << "{\"nodes\":" << nodes
+      << ",\"qsearch_nodes\":" << qsearch_nodes
+      << ",\"evaluations\":" << evaluations
+      << ",\"win_checks\":" << win_checks
+      << ",\"tt_probes\":" << tt_probes
+      << ",\"tt_hits\":" << tt_hits
+      << ",\"tt_cutoffs\":" << tt_cutoffs
+      << ",\"cutoffs\":" << cutoffs
+      << ",\"first_move_cutoffs\":" << first_move_cutoffs
+      << ",\"first_move_cutoff_rate\":" << Ratio(first_move_cutoffs, cutoffs)
+      << ",\"elapsed_ms\":" << Milliseconds(elapsed)
+      << ",\"time_to_deadline_ms\":";
+  if (time_to_deadline < Clock::duration(0))
+    out << "null";
+  else
+    out << Milliseconds(time_to_deadline);
+
+  out << ",\"iterations\":[";
+  for (int depth = 1; depth <= iterations; ++depth) {
+    uint64_t iteration = iteration_nodes[depth] - iteration_nodes[depth - 1];
+    uint64_t previous = depth > 1
+        ? iteration_nodes[depth - 1] - iteration_nodes[depth - 2] : 0;
+
+    if (depth > 1)
+      out << ",";
+    out << "{\"depth\":" << depth
+        << ",\"nodes\":" << iteration
+        << ",\"branching_factor\":" << Ratio(iteration, previous)
+        << ",\"elapsed_ms\":"
+        << Milliseconds(iteration_time[depth] - iteration_time[depth - 1])
+        << "}";
+  }
+  out << "]}" << std::endl;
+
+  out.flags(flags);
+  out.precision(precision);
+}
+
+void SearchStats::WriteSummary(std::ostream &out) const {
+  std::ios::fmtflags flags = out.flags();
+  std::streamsize precision = out.precision();
+
+  out << std::fixed << std::setprecision(1)
+      << "Search stats: evaluations = " << evaluations
+      << "; win checks = " << win_checks
+      << "; TT hits = " << tt_hits << "/" << tt_probes
+      << " (" << 100.0 * Ratio(tt_hits, tt_probes) << "%)"
+      << "; TT cutoffs = " << tt_cutoffs
+      << "; cutoffs = " << cutoffs
+      << " (" << 100.0 * Ratio(first_move_cutoffs, cutoffs)
+      << "% on the first move)" << std::endl;
+
+  for (int depth = 1; depth <= iterations; ++depth) {
+    uint64_t iteration = iteration_nodes[depth] - iteration_nodes[depth - 1];
+    uint64_t previous = depth > 1
+        ? iteration_nodes[depth - 1] - iteration_nodes[depth - 2] : 0;
+
+    out << std::setprecision(1)
+        << "Search stats: ply " << depth
+        << " took "
+        << Milliseconds(iteration_time[depth] - iteration_time[depth - 1])
+        << " ms"
+        << "; nodes = " << iteration
+        << "; branching factor = " << std::setprecision(2)
+        << Ratio(iteration, previous) << std::endl;
+  }
+
+  out.flags(flags);
+  out.precision(precision);
+}
+
+} // namespace wartzaar
@@ -0,0 +1,82 @@
+#ifndef WARTZAAR_SEARCH_STATS_H_
+#define WARTZAAR_SEARCH_STATS_H_
+
+#include <stdint.h>
+
+#include <chrono>
+#include <iosfwd>
+
+#include "wartzaar/clock.h"
+
+namespace wartzaar {
+
+///-----------------------------------------------------------------------------
+/// SearchStats counts where the effort of one search goes.
+///
+/// Each search thread keeps its own counters, so counting needs no locking,
+/// and the counters of all threads are added up when the search ends. The
+/// counters are only kept when WARTZAAR_SEARCH_STATS is defined; otherwise
+/// WARTZAAR_STAT compiles to nothing, and the search runs as if they did not
+/// exist. The Stats build configuration is Release with the define added.
+///-----------------------------------------------------------------------------
+struct SearchStats {
+  /// The deepest iteration recorded.
+  static const int kMaxDepth = 64;
+
+  /// Constructor creates cleared counters.
+  SearchStats();
+
+  /// Clears the counters for a new search.
+  void Clear();
+
+  /// Adds the counters of another thread to these. The iterations are only
+  /// recorded by the main thread, and are not added.
+  void Add(const SearchStats &that);
+
+  /// Records that the main thread completed an iteration of the given depth,
+  /// after the given total nodes and elapsed time.
+  void RecordIteration(int depth, uint64_t nodes, Clock::duration elapsed);
+
+  /// Writes the counters as a single line of JSON, with the totals of the
+  /// search. The time to the deadline is written as null if it is negative.
+  void WriteJson(std::ostream &out, uint64_t nodes, uint64_t qsearch_nodes,
+      Clock::duration elapsed, Clock::duration time_to_deadline) const;
+
+  /// Writes the counters for a person to read, one line per iteration.
+  void WriteSummary(std::ostream &out) const;
+
+  /// Leaf evaluations, in the main search and the quiescence search.
+  uint64_t evaluations;
+
+  /// Evaluations of the moves of the first two plies that look for a win
+  /// before searching them.
+  uint64_t win_checks;
+
+  /// Transposition table probes, the probes that found the state, and the
+  /// probes whose stored score ended the search of the state.
+  uint64_t tt_probes;
+  uint64_t tt_hits;
+  uint64_t tt_cutoffs;
+
+  /// Cutoffs in the main search, and the cutoffs caused by the first move
+  /// searched.
+  uint64_t cutoffs;
+  uint64_t first_move_cutoffs;
+
+  /// The deepest iteration completed by the main thread, and the total nodes
+  /// and elapsed time when each iteration ended, by depth.
+  int iterations;
+  uint64_t iteration_nodes[kMaxDepth + 1];
+  Clock::duration iteration_time[kMaxDepth + 1];
+};
+
+} // namespace wartzaar
+
+/// Increments the given counter of a SearchStats when statistics are kept.
+#ifdef WARTZAAR_SEARCH_STATS
+#define WARTZAAR_STAT(stats, counter) (++(stats).counter)
+#else
+#define WARTZAAR_STAT(stats, counter) ((void)0)
+#endif
+
+#endif // WARTZAAR_SEARCH_STATS_H_
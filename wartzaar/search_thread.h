@@ -0,0 +1,124 @@
+#ifndef WARTZAAR_SEARCH_THREAD_H_
+#define WARTZAAR_SEARCH_THREAD_H_
+
+#include <stdint.h>
+#include <string.h>  // for memset
+
+#include <chrono>
+
+#include "wartzaar/clock.h"
+#include "wartzaar/game_board.h"
+#include "wartzaar/game_state.h"
+#include "wartzaar/move.h"
+#include "wartzaar/search_stats.h"
+
+namespace wartzaar {
+
+struct SplitPoint;
+
+///-----------------------------------------------------------------------------
+/// SearchThread holds everything one search thread changes as it searches: its
+/// own copy of the game state, the root moves, the principal variation, the
+/// move ordering tables and the thread's results.
+///
+/// Search threads share only the transposition table and the split points
+/// they work on together, so each one orders its moves by what it has seen
+/// itself. Thread 0 is the main thread, which runs in the caller's thread and
+/// decides when the search ends.
+///-----------------------------------------------------------------------------
+struct SearchThread {
+  /// The deepest ply the search can reach.
+  static const int kMaxPly = 64;
+
+  /// Constructor creates an idle thread with the given number.
+  explicit SearchThread(int id);
+
+  int id;
+
+  /// The state being searched, made and taken back in place.
+  GameState state;
+
+  /// The depth of the current iteration, and of the last iteration that was
+  /// searched to the end (zero if none has been).
+  int root_depth;
+  int completed_depth;
+
+  /// The best move found so far by the current search, and its search score.
+  Move best_move;
+  float best_value;
+
+  /// The score of each iteration of the current search, by depth.
+  float iteration_scores[kMaxPly + 1];
+
+  /// The moves from the root state, in the order the root searches them, and
+  /// the score each one got in the last iteration.
+  MoveList root_moves;
+  float root_scores[MoveList::kMaxMoves];
+
+  /// The principal variation found by the current iteration. Row p holds the
+  /// best line found from the node at ply p, in plies p through
+  /// pv_length[p] - 1. The leaves are at ply kMaxPly at most.
+  Move pv[kMaxPly + 1][kMaxPly + 1];
+  int pv_length[kMaxPly + 1];
+
+  /// The principal variation of the last iteration, and whether the current
+  /// node is on it.
+  Move previous_pv[kMaxPly];
+  int previous_pv_length;
+  bool follow_pv;
+
+  /// The two most recent stacking moves that caused a cutoff at each ply.
+  Move killers[kMaxPly + 1][2];
+
+  /// The history score of each stacking move, by from and to cell. A move's
+  /// score grows each time it causes a cutoff.
+  int history[GameBoard::kNumCells][GameBoard::kNumCells];
+
+  /// The number of states visited by the main search and by the quiescence
+  /// search during the current search.
+  uint64_t nodes;
+  uint64_t qsearch_nodes;
+
+  /// The node count at which the thread next reads the clock.
+  uint64_t next_poll;
+
+  /// The thread's statistics for the current search, kept only when
+  /// WARTZAAR_SEARCH_STATS is defined.
+  SearchStats stats;
+
+  /// The split point the thread is working under, or null.
+  SplitPoint *split_point;
+
+  /// The number of split points the thread created and joined during the
+  /// current search, and the time it spent waiting for work.
+  uint64_t splits;
+  uint64_t steals;
+  Clock::duration idle_time;
+};
+
+inline SearchThread::SearchThread(int id)
+    : id(id),
+      state(GameBoard()),
+      root_depth(0),
+      completed_depth(0),
+      best_move(),
+      best_value(0.0f),
+      previous_pv_length(0),
+      follow_pv(false),
+      nodes(0),
+      qsearch_nodes(0),
+      next_poll(0),
+      stats(),
+      split_point(nullptr),
+      splits(0),
+      steals(0),
+      idle_time(0) {
+  memset(iteration_scores, 0, sizeof(iteration_scores));
+  memset(root_scores, 0, sizeof(root_scores));
+  memset(pv_length, 0, sizeof(pv_length));
+  memset(history, 0, sizeof(history));
+}
+
+} // namespace wartzaar
+
+#endif // WARTZAAR_SEARCH_THREAD_H_
@@ -0,0 +1,98 @@
+#ifndef WARTZAAR_SPLIT_POINT_H_
+#define WARTZAAR_SPLIT_POINT_H_
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+
+#include "wartzaar/game_state.h"
+#include "wartzaar/move.h"
+#include "wartzaar/search_thread.h"
+
+namespace wartzaar {
+
+///-----------------------------------------------------------------------------
+/// SplitPoint is a node whose remaining children are being searched by more
+/// than one thread at once.
+///
+/// The thread that owns the node creates the split point on its stack after
+/// searching the eldest child, and searches the other children along with
+/// any idle threads that join it. Each thread takes the next unsearched child
+/// and searches it against the bounds shared by the split point. A child that
+/// causes a cutoff sets cutoff, which stops every thread searching below the
+/// split point.
+///
+/// The members from moves through pv_length are guarded by lock. The others
+/// are set before the split point is published, and only read afterwards.
+///-----------------------------------------------------------------------------
+struct SplitPoint {
+  /// Constructor copies the state of the node.
+  explicit SplitPoint(const GameState &state);
+
+  /// The state of the node, which joining threads start from.
+  GameState state;
+
+  /// The split point the owner was working under, or null.
+  SplitPoint *parent;
+
+  /// The remaining depth and ply of the node, and the depth of the iteration.
+  int depth;
+  int ply;
+  int root_depth;
+
+  /// True if it is our move at the node.
+  bool maximizing;
+
+  std::mutex lock;
+
+  /// The next child to search, and the end of the children.
+  const Move *moves;
+  const Move *moves_end;
+
+  /// The bounds of the node, narrowed as children are searched.
+  float alpha;
+  float beta;
+
+  /// The best child so far, and the principal variation through it, in plies
+  /// ply through pv_length - 1.
+  Move best_move;
+  Move pv[SearchThread::kMaxPly + 1];
+  int pv_length;
+
+  /// The number of threads other than the owner working on the node.
+  int workers;
+
+  /// Set when a child causes a cutoff.
+  std::atomic<bool> cutoff;
+};
+
+///-----------------------------------------------------------------------------
+/// SplitQueue holds the split points of one thread that may still be joined,
+/// oldest first. The owner adds and removes split points at the back; idle
+/// threads look for work from the front, where the split points are nearest
+/// the root and have the most work left under them.
+///-----------------------------------------------------------------------------
+struct SplitQueue {
+  std::mutex lock;
+  std::deque<SplitPoint*> split_points;
+};
+
+inline SplitPoint::SplitPoint(const GameState &state)
+    : state(state),
+      parent(nullptr),
+      depth(0),
+      ply(0),
+      root_depth(0),
+      maximizing(false),
+      moves(nullptr),
+      moves_end(nullptr),
+      alpha(0.0f),
+      beta(0.0f),
+      best_move(),
+      pv_length(0),
+      workers(0),
+      cutoff(false) {}
+
+} // namespace wartzaar
+
+#endif // WARTZAAR_SPLIT_POINT_H_
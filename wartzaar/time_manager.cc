@@ -0,0 +1,106 @@
+#include "wartzaar/time_manager.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace wartzaar {
+
+namespace {
+
+/// The part of the budget kept back from the hard limit, for sending the move
+/// and for the threads to notice that the search has stopped.
+const int kSafetyMarginDivisor = 20;
+
+} // namespace
+
+TimeManager::TimeManager()
+    : node_limit_(0),
+      last_iteration_time_(0),
+      last_iteration_nodes_(0),
+      previous_iteration_nodes_(0),
+      total_nodes_(0) {
+  StartInfinite();
+}
+
+void TimeManager::Start(Clock::duration budget) {
+  start_ = Clock::now();
+  soft_limit_ = start_ + budget / 2;
+  hard_limit_ = start_ + budget - budget / kSafetyMarginDivisor;
+  node_limit_ = (std::numeric_limits<uint64_t>::max)();
+
+  last_iteration_end_ = start_;
+  last_iteration_time_ = Clock::duration(0);
+  last_iteration_nodes_ = 0;
+  previous_iteration_nodes_ = 0;
+  total_nodes_ = 0;
+}
+
+void TimeManager::StartInfinite() {
+  Start(Clock::duration(0));
+  soft_limit_ = Clock::time_point::max();
+  hard_limit_ = Clock::time_point::max();
+}
+
+void TimeManager::LimitNodes(uint64_t node_limit) {
+  node_limit_ = node_limit;
+}
+
+void TimeManager::CompleteIteration(uint64_t nodes) {
+  Clock::time_point now = Clock::now();
+
+  last_iteration_time_ = now - last_iteration_end_;
+  last_iteration_end_ = now;
+
+  previous_iteration_nodes_ = last_iteration_nodes_;
+  last_iteration_nodes_ = nodes - total_nodes_;
+  total_nodes_ = nodes;
+}
+
+/// Until two iterations have searched some nodes, there is nothing to predict
+/// from, and only the soft limit applies.
+///
+bool TimeManager::CanStartIteration() const {
+  Clock::time_point now = Clock::now();
+  if (now >= soft_limit_)
+    return false;
+
+  if (hard_limit_ == Clock::time_point::max()
+      || previous_iteration_nodes_ == 0)
+    return true;
+
+  double branching_factor = (std::min)(
+      static_cast<double>(last_iteration_nodes_) / previous_iteration_nodes_,
+      static_cast<double>(kMaxBranchingFactor));
+  std::chrono::duration<double> predicted_time =
+      last_iteration_time_ * branching_factor;
+
+  return predicted_time < hard_limit_ - now;
+}
+
+bool TimeManager::HardLimitReached() const {
+  return Clock::now() >= hard_limit_;
+}
+
+bool TimeManager::NodeLimitReached(uint64_t nodes) const {
+  return nodes >= node_limit_;
+}
+
+uint64_t TimeManager::NextPoll(uint64_t nodes) const {
+  if (nodes < node_limit_ && node_limit_ - nodes < kPollInterval)
+    return node_limit_;
+
+  return nodes + kPollInterval;
+}
+
+Clock::duration TimeManager::TimeLeft() const {
+  if (hard_limit_ == Clock::time_point::max())
+    return Clock::duration(-1);
+
+  return hard_limit_ - Clock::now();
+}
+
+Clock::duration TimeManager::Elapsed() const {
+  return Clock::now() - start_;
+}
+
+} // namespace wartzaar
@@ -0,0 +1,102 @@
+#ifndef WARTZAAR_TIME_MANAGER_H_
+#define WARTZAAR_TIME_MANAGER_H_
+
+#include <stdint.h>
+
+#include <chrono>
+
+#include "wartzaar/clock.h"
+
+namespace wartzaar {
+
+///-----------------------------------------------------------------------------
+/// TimeManager decides how much of a move's time budget the search uses.
+///
+/// Time is measured on the monotonic Clock, so it is elapsed time whatever
+/// the number of search threads. Each search has two limits:
+///
+/// - The hard limit is the budget less a safety margin. The search is stopped
+///   when it is reached, even part way through an iteration.
+/// - The soft limit is half the budget. No new iteration is started after it,
+///   since the next iteration would not be expected to finish.
+///
+/// Before the soft limit, a new iteration is only started if it is predicted
+/// to finish before the hard limit. The prediction multiplies the time of the
+/// last iteration by the effective branching factor: the ratio of the nodes
+/// searched by the last two iterations.
+///
+/// Reading the clock costs far more than searching a node, so the search only
+/// polls the hard limit every kPollInterval nodes of each thread.
+///
+/// A search may also be limited to a number of nodes of the main thread. The
+/// main thread then polls exactly when it reaches the limit, so a search with
+/// no time limits and a single thread always stops at the same node.
+///-----------------------------------------------------------------------------
+class TimeManager {
+ public:
+  /// The number of nodes a thread searches between polls of the clock.
+  static const int kPollInterval = 1024;
+
+  /// Constructor creates a manager with no limits.
+  TimeManager();
+
+  /// Starts timing a search with the given budget.
+  void Start(Clock::duration budget);
+
+  /// Starts timing a search with no limits.
+  void StartInfinite();
+
+  /// Limits the search that was just started to the given number of nodes of
+  /// the main thread.
+  void LimitNodes(uint64_t node_limit);
+
+  /// Records that an iteration of the main search thread ended, after the
+  /// given total number of nodes had been searched since the start.
+  void CompleteIteration(uint64_t nodes);
+
+  /// Returns true if there is time to search another iteration.
+  bool CanStartIteration() const;
+
+  /// Returns true once the hard limit has been reached.
+  bool HardLimitReached() const;
+
+  /// Returns true once the main thread has searched the given number of
+  /// nodes and that is at least the node limit.
+  bool NodeLimitReached(uint64_t nodes) const;
+
+  /// Returns the node count at which a thread that has searched the given
+  /// number of nodes next polls the limits.
+  uint64_t NextPoll(uint64_t nodes) const;
+
+  /// Returns the time left until the hard limit, or a negative duration if
+  /// the search has no hard limit or has passed it.
+  Clock::duration TimeLeft() const;
+
+  /// Returns the time since the search started.
+  Clock::duration Elapsed() const;
+
+ private:
+  /// The largest effective branching factor assumed. Iterations that only
+  /// visit a few nodes can show any ratio.
+  static const int kMaxBranchingFactor = 64;
+
+  /// When the search started, and its limits.
+  Clock::time_point start_;
+  Clock::time_point soft_limit_;
+  Clock::time_point hard_limit_;
+  uint64_t node_limit_;
+
+  /// When the last iteration ended, and how long it took.
+  Clock::time_point last_iteration_end_;
+  Clock::duration last_iteration_time_;
+
+  /// The nodes searched by the last two iterations, and the total searched
+  /// when the last one ended.
+  uint64_t last_iteration_nodes_;
+  uint64_t previous_iteration_nodes_;
+  uint64_t total_nodes_;
+};
+
+} // namespace wartzaar
+
+#endif // WARTZAAR_TIME_MANAGER_H_
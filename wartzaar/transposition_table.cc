@@ -0,0 +1,130 @@
+#include "wartzaar/transposition_table.h"
+
+#include <string.h>  // for memcpy, memset
+
+namespace wartzaar {
+
+TranspositionTable::TranspositionTable(size_t size_mb)
+    : bucket_mask_(0),
+      age_(0) {
+  Resize(size_mb);
+}
+
+void TranspositionTable::Resize(size_t size_mb) {
+  size_t bucket_bytes = kBucketSize * sizeof(Slot);
+  size_t max_buckets = (size_mb << 20) / bucket_bytes;
+
+  // Round down to a power of two, keeping at least one bucket
+  size_t buckets = 1;
+  while (buckets * 2 <= max_buckets)
+    buckets *= 2;
+
+  entries_.assign(buckets * kBucketSize, Slot());
+  bucket_mask_ = buckets - 1;
+  Clear();
+}
+
+void TranspositionTable::Clear() {
+  if (!entries_.empty())
+    memset(&entries_[0], 0, entries_.size() * sizeof(Slot));
+  age_ = 0;
+}
+
+void TranspositionTable::NewSearch() {
+  age_ = (age_ + 1) & (0xff >> kBoundBits);
+}
+
+bool TranspositionTable::Probe(uint64_t key, TranspositionEntry &entry) const {
+  const Slot *bucket = &entries_[BucketIndex(key)];
+
+  for (int i = 0; i < kBucketSize; ++i) {
+    Load(bucket[i], entry);
+    if (entry.key == key && (entry.bound_age & kBoundMask) != kNone)
+      return true;
+  }
+
+  return false;
+}
+
+/// An existing entry for the same key keeps its best move when the new result
+/// has none, so a fail-low search doesn't erase the move ordering hint.
+///
+void TranspositionTable::Store(uint64_t key, int depth, Bound bound,
+    float score, const Move &best_move) {
+  Slot *bucket = &entries_[BucketIndex(key)];
+  Slot *replace = &bucket[0];
+  TranspositionEntry replace_entry = TranspositionEntry();
+  int replace_worth = 0x7fffffff;
+
+  for (int i = 0; i < kBucketSize; ++i) {
+    TranspositionEntry entry;
+    Load(bucket[i], entry);
+
+    if (entry.key == key || (entry.bound_age & kBoundMask) == kNone) {
+      replace = &bucket[i];
+      replace_entry = entry;
+      break;
+    }
+
+    // Entries from the current search are worth more than stale ones; among
+    // those, deeper searches are worth more.
+    int worth = entry.depth;
+    if ((entry.bound_age >> kBoundBits) == age_)
+      worth += 256;
+
+    if (worth < replace_worth) {
+      replace = &bucket[i];
+      replace_entry = entry;
+      replace_worth = worth;
+    }
+  }
+
+  uint16_t move = best_move.value();
+  if (move == 0 && replace_entry.key == key)
+    move = replace_entry.move;
+
+  uint32_t score_bits;
+  memcpy(&score_bits, &score, sizeof(score_bits));
+
+  uint64_t data = score_bits
+      | static_cast<uint64_t>(move) << 32
+      | static_cast<uint64_t>(static_cast<uint8_t>(depth)) << 48
+      | static_cast<uint64_t>((age_ << kBoundBits) | bound) << 56;
+
+  replace->check = key ^ data;
+  replace->data = data;
+}
+
+TranspositionTable::Bound TranspositionTable::EntryBound(
+    const TranspositionEntry &entry) {
+  return static_cast<Bound>(entry.bound_age & kBoundMask);
+}
+
+Move TranspositionTable::EntryMove(const TranspositionEntry &entry) {
+  return Move::FromValue(entry.move);
+}
+
+size_t TranspositionTable::size() const {
+  return entries_.size();
+}
+
+size_t TranspositionTable::BucketIndex(uint64_t key) const {
+  return static_cast<size_t>(key & bucket_mask_) * kBucketSize;
+}
+
+/// Each word is read once, so a torn entry fails the key check as a whole.
+///
+void TranspositionTable::Load(const Slot &slot, TranspositionEntry &entry) {
+  uint64_t data = slot.data;
+  uint64_t check = slot.check;
+
+  uint32_t score_bits = static_cast<uint32_t>(data);
+  memcpy(&entry.score, &score_bits, sizeof(entry.score));
+
+  entry.key = check ^ data;
+  entry.move = static_cast<uint16_t>(data >> 32);
+  entry.depth = static_cast<int8_t>(data >> 48);
+  entry.bound_age = static_cast<uint8_t>(data >> 56);
+}
+
+} // namespace wartzaar
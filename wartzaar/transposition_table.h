@@ -0,0 +1,126 @@
+#ifndef WARTZAAR_TRANSPOSITION_TABLE_H_
+#define WARTZAAR_TRANSPOSITION_TABLE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "wartzaar/move.h"
+
+namespace wartzaar {
+
+///-----------------------------------------------------------------------------
+/// A single transposition table entry, as returned by a probe.
+///-----------------------------------------------------------------------------
+struct TranspositionEntry {
+  /// The full Zobrist key of the stored state.
+  uint64_t key;
+
+  /// The search score, which is exact or a bound depending on bound().
+  float score;
+
+  /// The packed value of the best move found, or zero if none.
+  uint16_t move;
+
+  /// The remaining search depth the score was computed with.
+  int8_t depth;
+
+  /// The bound type in the low two bits, and the search age in the rest.
+  uint8_t bound_age;
+};
+
+///-----------------------------------------------------------------------------
+/// TranspositionTable caches search results by Zobrist key.
+///
+/// The table is a power-of-two number of buckets, each holding four entries
+/// (one cache line). A new result replaces the entry for the same key if there
+/// is one; otherwise it replaces the entry that is least worth keeping: empty
+/// entries first, then entries left over from earlier searches, then the
+/// shallowest.
+///
+/// The table is shared by all search threads without locks. Each entry is
+/// stored as two 64-bit words: the score, move, depth and bound packed into a
+/// data word, and the key XORed with the data word. Two threads writing the
+/// same entry at once can leave the words of different results together; the
+/// key then no longer matches, so a probe sees an empty entry instead of a
+/// wrong result.
+///-----------------------------------------------------------------------------
+class TranspositionTable {
+ public:
+  /// How the stored score relates to the true score of the state.
+  enum Bound {
+    kNone       = 0,
+    kExact      = 1,
+    kLowerBound = 2,  ///< The true score is at least the stored score.
+    kUpperBound = 3   ///< The true score is at most the stored score.
+  };
+
+  /// The number of entries in each bucket.
+  static const int kBucketSize = 4;
+
+  /// Constructor allocates a table of at most size_mb megabytes.
+  explicit TranspositionTable(size_t size_mb);
+
+  /// Reallocates the table with at most size_mb megabytes, clearing it.
+  void Resize(size_t size_mb);
+
+  /// Removes all entries from the table.
+  void Clear();
+
+  /// Marks the start of a new search, so entries from earlier searches are
+  /// replaced first. No thread may be searching.
+  void NewSearch();
+
+  /// Looks up the given key. Returns true and fills entry if it is stored.
+  /// This is safe to call from any number of threads at once.
+  bool Probe(uint64_t key, TranspositionEntry &entry) const;
+
+  /// Stores a search result for the given key. This is safe to call from any
+  /// number of threads at once.
+  void Store(uint64_t key, int depth, Bound bound, float score,
+      const Move &best_move);
+
+  /// Returns the bound type of an entry.
+  static Bound EntryBound(const TranspositionEntry &entry);
+
+  /// Returns the best move of an entry.
+  static Move EntryMove(const TranspositionEntry &entry);
+
+  /// Returns the number of entries in the table.
+  size_t size() const;
+
+ private:
+  static const int kBoundBits = 2;
+  static const uint8_t kBoundMask = 0x3;
+
+  /// An entry as it is stored in the table.
+  struct Slot {
+    /// The key XORed with data.
+    uint64_t check;
+
+    /// The entry's score, move, depth and bound_age, packed from the lowest
+    /// bits up.
+    uint64_t data;
+  };
+
+  /// Returns the first entry of the bucket for the given key.
+  size_t BucketIndex(uint64_t key) const;
+
+  /// Reads a slot into entry, which is left empty if the slot's words don't
+  /// belong together.
+  static void Load(const Slot &slot, TranspositionEntry &entry);
+
+  std::vector<Slot> entries_;
+
+  /// The number of buckets, less one. The number of buckets is a power of
+  /// two, so this masks a key down to a bucket number.
+  size_t bucket_mask_;
+
+  /// The age of the current search, which wraps around after 63.
+  uint8_t age_;
+};
+
+} // namespace wartzaar
+
+#endif // WARTZAAR_TRANSPOSITION_TABLE_H_
@@ -0,0 +1,17 @@
+#ifndef WARTZAAR_TYPES_PARALLEL_SEARCH_H_
+#define WARTZAAR_TYPES_PARALLEL_SEARCH_H_
+
+namespace wartzaar { namespace types { namespace parallelsearch {
+
+/// The ways the search can use more than one thread.
+///
+/// With lazy SMP, every thread searches the whole tree from the root, and the
+/// threads help each other only through the transposition table. With Young
+/// Brothers Wait, the children of a node are split between the threads once
+/// its eldest child has been searched.
+///
+enum ParallelSearch { kLazySmp = 1, kYoungBrothersWait = 2 };
+
+}}} // namespace wartzaar::types::parallelsearch
+
+#endif // WARTZAAR_TYPES_PARALLEL_SEARCH_H_
@@ -2,141 +2,890 @@
 
 #include <math.h>   // for log
 
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
+#include <thread>
+
+#include "wartzaar/move_generator.h"
 
 namespace wm   = wartzaar::messages;
 namespace wtc  = wartzaar::types::color;
 namespace wtd  = wartzaar::types::direction;
 namespace wtpn = wartzaar::types::playernumber;
+namespace wtps = wartzaar::types::parallelsearch;
 namespace wtpt = wartzaar::types::piecetype;
 
 namespace wartzaar {
 
+namespace {
+
+/// The half-width of the first aspiration window, in evaluation units. A
+/// search that falls outside the window is repeated with the window widened
+/// four times over, and with no window once it is wider than
+/// kMaxAspirationWindow.
+const float kAspirationWindow = 16.0f;
+const float kMaxAspirationWindow = 64.0f;
+
+/// The width of the window that tests whether a move beats the best so far.
+/// Scores are floats, so the window cannot be empty; a score that falls
+/// inside it is treated as beating the best, and searched again.
+const float kScoutWindow = 0.001f;
+
+/// The least remaining depth at which a node's children are split between
+/// threads. Shallower subtrees are searched faster than a split is set up.
+const int kMinSplitDepth = 3;
+
+} // namespace
+
 TzaarGame::TzaarGame(int turn_time, int search_depth, int beam_size,
-    int tzaar_coefficient, int tzarra_coefficient, int tott_coefficient,
-    int stack_coefficient)
+    int hash_mb, int qsearch_depth, int threads, int tzaar_coefficient,
+    int tzarra_coefficient, int tott_coefficient, int stack_coefficient)
     : turn_time_(turn_time),
       max_depth_(search_depth),
-      local_depth_(0),
       beam_size_(beam_size),
+      qsearch_depth_(qsearch_depth),
       tzaar_coefficient_(tzaar_coefficient),
       tzarra_coefficient_(tzarra_coefficient),
       tott_coefficient_(tott_coefficient),
       stack_coefficient_(stack_coefficient),
       current_state_(GameState(GameBoard())),
-      best_move_(GameState(GameBoard())),
+      parallel_search_(wtps::kLazySmp),
+      idle_threads_(0),
       player_color_(),
       player_number_(),
       turn_count_(0),
       turn_move_count_(0),
-      turn_move_timeout_(0) {
+      stop_(false),
+      quiet_(false),
+      timed_(true),
+      node_limit_(0),
+      search_nodes_(0),
+      ponder_(false),
+      pondering_(false),
+      planned_move_(),
+      planned_hash_(0),
+      turn_deadline_(Clock::time_point::max()),
+      transposition_table_(hash_mb) {
+  if (threads < 1)
+    throw std::runtime_error("Can't create game: invalid number of threads!");
+
+  for (int id = 0; id < threads; ++id)
+    threads_.push_back(SearchThread(id));
+  std::vector<SplitQueue>(threads).swap(split_queues_);
+
   Init();
 }
 
+TzaarGame::~TzaarGame() {
+  StopPondering();
+}
+
 void TzaarGame::Init() {
-  directions_.push_back(wtd::kNorth);
-  directions_.push_back(wtd::kNortheast);
-  directions_.push_back(wtd::kSoutheast);
-  directions_.push_back(wtd::kSouth);
-  directions_.push_back(wtd::kSouthwest);
-  directions_.push_back(wtd::kNorthwest);
-
-  ln_[15] = 2.6461748f;
-  ln_[14] = 2.57261223f;
-  ln_[13] = 2.49320545f;
-  ln_[12] = 2.40694511f;
-  ln_[11] = 2.31253542f;
-  ln_[10] = 2.20827441f;
-  ln_[9]  = 2.09186406f;
-  ln_[8]  = 1.96009478f;
-  ln_[7]  = 1.80828877f;
-  ln_[6]  = 1.62924054f;
-  ln_[5]  = 1.41098697f;
-  ln_[4]  = 1.13140211f;
-  ln_[3]  = 0.741937345f;
-  ln_[2]  = 0.0953101798f;
-  ln_[1]  = -2.30258509f;
-  ln_[0]  = 0.0f;
+  BuildEvaluationTables();
 }
 
+/// The two moves of a turn are planned together. The search for the first
+/// move also searches the second move after each capture, so the second move
+/// of its principal variation is kept as the plan for the rest of the turn,
+/// and the first search is given the time of both moves. If the principal
+/// variation ends after the first move, the plan is the best move stored for
+/// the state after it. When the second move is asked for, the plan is played
+/// at once if the board is still the one it was made for; otherwise the
+/// second move is searched in what is left of the turn's time.
+///
 wm::MoveMessage TzaarGame::GetNextMove(bool capture_only) {
-  // Initialize the best move
-  best_move_ = GameState(GameBoard());
+  StopPondering();
 
-  // Wind up the alarm clock
-  turn_move_timeout_ = clock() + turn_time_ * CLOCKS_PER_SEC;
+  Clock::time_point turn_deadline = turn_deadline_;
+  turn_deadline_ = Clock::time_point::max();
 
-  // Execute the minimax search using depth-first iterative deepening (DFID)
-  for (local_depth_ = 1; local_depth_ <= max_depth_ && clock() < turn_move_timeout_; local_depth_++) {
-      Minimax(current_state_, local_depth_, -float_max_, float_max_, player_color_, capture_only);
+  // It's our move. The first turn of the game is a single capturing move.
+  bool single_move_turn = turn_count_ == 0;
+  current_state_.SetTurn(player_color_, capture_only, single_move_turn);
 
-    std::cout << "TzaarGame::GetNextMove: Completed minimax search for ply = " << local_depth_
-              << "; current best move = " << best_move_.ToString()
-              << "; hval = " << best_move_.heuristic_value()
+  // Play the rest of the turn as planned
+  if (!capture_only && !planned_move_.IsNull()
+      && current_state_.hash() == planned_hash_) {
+    Move planned_move = planned_move_;
+    planned_move_ = Move();
+    search_nodes_ = 0;
+
+    if (!quiet_) {
+      std::cout << "TzaarGame::GetNextMove: Playing planned move "
+                << planned_move.ToString() << std::endl;
+    }
+
+    return PlayMove(planned_move);
+  }
+
+  planned_move_ = Move();
+  bool plan_turn = capture_only && !single_move_turn;
+
+  // Entries from earlier searches are kept, but replaced first
+  transposition_table_.NewSearch();
+
+  // Wind up the alarm clock, unless the search is limited only by depth or
+  // nodes, which makes it repeatable
+  Clock::duration budget = std::chrono::seconds(turn_time_);
+  Clock::time_point now = Clock::now();
+  if (plan_turn) {
+    budget *= 2;
+    turn_deadline_ = now + budget;
+  }
+  else if (!capture_only
+      && turn_deadline != Clock::time_point::max()) {
+    budget = (std::max)(turn_deadline - now, Clock::duration(0));
+  }
+
+  if (timed_)
+    time_manager_.Start(budget);
+  else
+    time_manager_.StartInfinite();
+  if (node_limit_ > 0)
+    time_manager_.LimitNodes(node_limit_);
+  stop_ = false;
+
+  // The root moves start in the usual move order, and each thread reorders
+  // its own copy by their scores after each iteration
+  MoveList root_moves;
+  MoveGenerator::GenerateMoves(current_state_, player_color_, capture_only,
+      root_moves);
+  if (!capture_only)
+    root_moves.Add(Move::Pass());
+
+  Search(root_moves);
+
+  const SearchThread &best = BestThread();
+  uint64_t nodes = 0;
+  uint64_t qsearch_nodes = 0;
+  uint64_t splits = 0;
+  uint64_t steals = 0;
+  Clock::duration idle_time(0);
+  for (size_t i = 0; i < threads_.size(); ++i) {
+    nodes += threads_[i].nodes;
+    qsearch_nodes += threads_[i].qsearch_nodes;
+    splits += threads_[i].splits;
+    steals += threads_[i].steals;
+    idle_time += threads_[i].idle_time;
+  }
+
+  search_nodes_ = nodes + qsearch_nodes;
+
+  if (!quiet_) {
+    Clock::duration elapsed = time_manager_.Elapsed();
+    double seconds = std::chrono::duration<double>(elapsed).count();
+
+    std::cout << "TzaarGame::GetNextMove: Searched "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(
+                     elapsed).count()
+              << " ms with " << threads_.size() << " threads"
+              << "; best move " << best.best_move.ToString()
+              << " from thread " << best.id
+              << " at ply " << best.completed_depth
+              << "; nodes = " << nodes
+              << "; qsearch nodes = " << qsearch_nodes
+              << "; nodes/s = "
+              << static_cast<uint64_t>(
+                     seconds > 0.0 ? search_nodes_ / seconds : 0.0)
               << std::endl;
 
+#ifdef WARTZAAR_SEARCH_STATS
+    SearchStats stats = threads_[0].stats;
+    for (size_t i = 1; i < threads_.size(); ++i)
+      stats.Add(threads_[i].stats);
+
+    stats.WriteJson(std::cout, nodes, qsearch_nodes, elapsed,
+        time_manager_.TimeLeft());
+    stats.WriteSummary(std::cout);
+#endif
+
+    if (parallel_search_ == wtps::kYoungBrothersWait && threads_.size() > 1) {
+      std::cout << "TzaarGame::GetNextMove: Splits = " << splits
+                << "; steals = " << steals
+                << "; idle time = "
+                << std::chrono::duration_cast<std::chrono::milliseconds>(
+                       idle_time).count()
+                << " ms" << std::endl;
+    }
+  }
+
+  // Pass if there is no move to make
+  Move best_move = best.best_move;
+  if (best_move.IsNull())
+    best_move = Move::Pass();
+
+  // Plan the second move of the turn along the principal variation
+  Move planned_move;
+  if (plan_turn && best.previous_pv_length >= 2
+      && best.previous_pv[0] == best_move)
+    planned_move = best.previous_pv[1];
+
+  wm::MoveMessage message = PlayMove(best_move);
+
+  if (plan_turn && planned_move.IsNull()
+      && current_state_.color_to_move() == player_color_)
+    planned_move = StoredMove();
+
+  if (!planned_move.IsNull()) {
+    planned_move_ = planned_move;
+    planned_hash_ = current_state_.hash();
+
+    if (!quiet_) {
+      std::cout << "TzaarGame::GetNextMove: Planned move "
+                << planned_move_.ToString() << std::endl;
+    }
+  }
+
+  return message;
+}
+
+wm::MoveMessage TzaarGame::PlayMove(const Move &move) {
+  UndoRecord undo;
+  current_state_.MakeMove(move, undo);
+
+  if (move.IsPass()) {
+    StartPondering();
+    return wm::MoveMessage();
+  }
+
+  if (!quiet_) {
+    std::cout << "Best move piece counts: " << move.ToString()
+              << ": W("  << current_state_.GetPieceCount(wtc::kWhite, wtpt::kTzaar)
+              << ", "    << current_state_.GetPieceCount(wtc::kWhite, wtpt::kTzarra)
+              << ", "    << current_state_.GetPieceCount(wtc::kWhite, wtpt::kTott)
+              << "), B(" << current_state_.GetPieceCount(wtc::kBlack, wtpt::kTzaar)
+              << ", "    << current_state_.GetPieceCount(wtc::kBlack, wtpt::kTzarra)
+              << ", "    << current_state_.GetPieceCount(wtc::kBlack, wtpt::kTott)
+              << ")"     << std::endl;
+  }
+
+  StartPondering();
+  return wm::MoveMessage(move);
+}
+
+/// The stored move is checked against the moves of the state, since another
+/// state may share its key.
+///
+Move TzaarGame::StoredMove() const {
+  TranspositionEntry entry;
+  if (!transposition_table_.Probe(current_state_.hash(), entry))
+    return Move();
+
+  MoveList moves;
+  MoveGenerator::GenerateMoves(current_state_, current_state_.color_to_move(),
+      current_state_.capture_only(), moves);
+  if (!current_state_.capture_only())
+    moves.Add(Move::Pass());
+
+  Move move = TranspositionTable::EntryMove(entry);
+  if (std::find(moves.begin(), moves.end(), move) == moves.end())
+    return Move();
+
+  return move;
+}
+
+void TzaarGame::Search(MoveList root_moves) {
+  for (size_t i = 0; i < threads_.size(); ++i)
+    StartThread(threads_[i], root_moves);
+
+  // The helpers search until the main thread is done
+  std::vector<std::thread> helpers;
+  for (size_t i = 1; i < threads_.size(); ++i) {
+    if (parallel_search_ == wtps::kYoungBrothersWait)
+      helpers.push_back(std::thread(&TzaarGame::HelpSearch, this,
+          std::ref(threads_[i])));
+    else
+      helpers.push_back(std::thread(&TzaarGame::IterativeDeepening, this,
+          std::ref(threads_[i])));
+  }
+
+  IterativeDeepening(threads_[0]);
+
+  stop_ = true;
+  for (size_t i = 0; i < helpers.size(); ++i)
+    helpers[i].join();
+}
+
+/// Pondering searches every reply of the opponent, as if it were our own
+/// search with the opponent to move at the root, with no time limit. It only
+/// fills the transposition table: when the opponent's move arrives, the
+/// results under it are found there by the next search, and the rest are
+/// replaced first. The search stops when the opponent's move arrives, and
+/// starts again from the new state if the opponent has a second move to
+/// make.
+///
+void TzaarGame::StartPondering() {
+  if (!ponder_ || current_state_.color_to_move() == player_color_)
+    return;
+
+  StopPondering();
+
+  MoveList root_moves;
+  MoveGenerator::GenerateMoves(current_state_, current_state_.color_to_move(),
+      current_state_.capture_only(), root_moves);
+  if (!current_state_.capture_only())
+    root_moves.Add(Move::Pass());
+
+  if (root_moves.empty())
+    return;
+
+  transposition_table_.NewSearch();
+  time_manager_.StartInfinite();
+  stop_ = false;
+  pondering_ = true;
+
+  ponder_thread_ = std::thread(&TzaarGame::Search, this, root_moves);
+}
+
+bool TzaarGame::StopPondering() {
+  if (!ponder_thread_.joinable())
+    return false;
+
+  stop_ = true;
+  ponder_thread_.join();
+  pondering_ = false;
+
+  const SearchThread &main_thread = threads_[0];
+  uint64_t nodes = 0;
+  for (size_t i = 0; i < threads_.size(); ++i)
+    nodes += threads_[i].nodes + threads_[i].qsearch_nodes;
+
+  if (!quiet_) {
+    std::cout << "TzaarGame::StopPondering: Pondered "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(
+                     time_manager_.Elapsed()).count()
+              << " ms to ply " << main_thread.completed_depth
+              << "; nodes = " << nodes
+              << std::endl;
+  }
+
+  return true;
+}
+
+/// The killer moves are kept from the last search, and the history scores
+/// are halved.
+///
+void TzaarGame::StartThread(SearchThread &thread, const MoveList &root_moves) {
+  thread.state = current_state_;
+  thread.root_depth = 0;
+  thread.completed_depth = 0;
+  thread.best_move = Move();
+  thread.best_value = -float_max_;
+  thread.nodes = 0;
+  thread.qsearch_nodes = 0;
+  thread.next_poll = time_manager_.NextPoll(0);
+  thread.stats.Clear();
+  thread.split_point = nullptr;
+  thread.splits = 0;
+  thread.steals = 0;
+  thread.idle_time = Clock::duration(0);
+  AgeHistory(thread);
+
+  for (int depth = 0; depth <= SearchThread::kMaxPly; ++depth)
+    thread.iteration_scores[depth] = -float_max_;
+
+  thread.root_moves = root_moves;
+  thread.follow_pv = false;
+  OrderMoves(thread, thread.root_moves, 0, Move());
+  for (int i = 0; i < thread.root_moves.size(); ++i)
+    thread.root_scores[i] = -float_max_;
+  thread.previous_pv_length = 0;
+}
+
+/// Helper threads search the same root as the main thread, and gain from
+/// each other only through the transposition table. Every other helper
+/// searches each iteration one ply deeper than the main thread, so that the
+/// threads spread out over different parts of the tree instead of all
+/// searching the same nodes in step. The first thread to store a result
+/// saves the others from searching it.
+///
+void TzaarGame::IterativeDeepening(SearchThread &thread) {
+  int depth_offset = thread.id % 2;
+
+  // A helper a ply ahead stops a ply early, so that no thread searches
+  // deeper than the principal variation arrays reach
+  for (int depth = 1; depth <= max_depth_
+       && depth + depth_offset <= SearchThread::kMaxPly && !Stopped();
+       ++depth) {
+    thread.root_depth = (std::min)(depth + depth_offset, max_depth_);
+    SearchRoot(thread);
+    thread.iteration_scores[thread.root_depth] = thread.best_value;
+    if (!Stopped()) {
+      thread.completed_depth = thread.root_depth;
+#ifdef WARTZAAR_SEARCH_STATS
+      if (thread.id == 0)
+        thread.stats.RecordIteration(thread.root_depth,
+            thread.nodes + thread.qsearch_nodes, time_manager_.Elapsed());
+#endif
+    }
+
+    // Search the best line of this iteration first in the next one. Once
+    // the search has stopped, the line only comes from a root move that was
+    // searched to the end, and is kept only if there was one.
+    if (!Stopped() || thread.pv_length[0] > 0) {
+      thread.previous_pv_length = thread.pv_length[0];
+      for (int ply = 0; ply < thread.previous_pv_length; ++ply)
+        thread.previous_pv[ply] = thread.pv[0][ply];
+    }
+    SortRootMoves(thread);
+
+    if (thread.id == 0 && !pondering_ && !quiet_) {
+      std::cout << "TzaarGame::GetNextMove: Completed minimax search for ply = " << thread.root_depth
+                << "; current best move = " << thread.best_move.ToString()
+                << "; hval = " << thread.best_value
+                << "; nodes = " << thread.nodes
+                << "; qsearch nodes = " << thread.qsearch_nodes
+                << std::endl;
+    }
+
     // Stop searching for moves if a win state was found
-    if (best_move_.heuristic_value() == float_max_)
+    if (thread.best_value == float_max_)
       break;
+
+    // The main thread decides whether the next iteration can finish in time
+    if (thread.id == 0) {
+      time_manager_.CompleteIteration(thread.nodes + thread.qsearch_nodes);
+      if (!Stopped() && !time_manager_.CanStartIteration())
+        break;
+    }
   }
+}
 
-  current_state_ = best_move_;
+const SearchThread& TzaarGame::BestThread() const {
+  const SearchThread *best = &threads_[0];
 
-  std::cout << "Clock: " << clock() << ", Timeout: " << turn_move_timeout_ << std::endl;
-  std::cout << "Best move piece counts: " << best_move_.ToString()
-            << ": W("  << best_move_.GetPieceCount(wtc::kWhite, wtpt::kTzaar)
-            << ", "    << best_move_.GetPieceCount(wtc::kWhite, wtpt::kTzarra)
-            << ", "    << best_move_.GetPieceCount(wtc::kWhite, wtpt::kTott)
-            << "), B(" << best_move_.GetPieceCount(wtc::kBlack, wtpt::kTzaar)
-            << ", "    << best_move_.GetPieceCount(wtc::kBlack, wtpt::kTzarra)
-            << ", "    << best_move_.GetPieceCount(wtc::kBlack, wtpt::kTott)
-            << ")"     << std::endl;
+  for (size_t i = 1; i < threads_.size(); ++i)
+    if (threads_[i].completed_depth > best->completed_depth
+        && !threads_[i].best_move.IsNull())
+      best = &threads_[i];
 
-  return wm::MoveMessage(
-    best_move_.last_move_from()->col(),
-    best_move_.last_move_from()->row(),
-    best_move_.last_move_to()->col(),
-    best_move_.last_move_to()->row()
-  );
+  return *best;
 }
 
-float TzaarGame::Minimax(GameState &state, int depth, float alpha, float beta,
-    wtc::Color color, bool capture_only) {
-  // Bail out if we're at the depth limit
-  if (depth == 0 || clock() >= turn_move_timeout_)
-    return EvaluateHeuristic(state, color, capture_only);
+bool TzaarGame::Stopped() {
+  if (stop_.load(std::memory_order_relaxed))
+    return true;
 
-  // Get successor states
-  std::vector<GameState> successors = FindSuccessors(state, color, capture_only);
+  if (time_manager_.HardLimitReached()) {
+    stop_ = true;
+    return true;
+  }
 
-//  std::cout << "Have " << successors.size() << " successors for "
-//            << (capture_only ? "capture_only" : "!capture_only") << " move"
-//            << std::endl;
+  return false;
+}
 
-  // Bail out if this is a terminal (leaf) state
-  if (successors.size() == 0)
-    return EvaluateHeuristic(state, color, capture_only);
+/// A Young Brothers Wait helper has no root of its own. It waits for another
+/// thread to split a node, joins it, and searches children of the node in
+/// the state the split point was made in, at the same iteration depth as its
+/// owner, so that plies are counted the same way.
+///
+void TzaarGame::HelpSearch(SearchThread &thread) {
+  ++idle_threads_;
+
+  while (!stop_.load(std::memory_order_relaxed)) {
+    Clock::time_point idle_start = Clock::now();
+    SplitPoint *split_point = StealSplitPoint(thread, nullptr);
+    if (split_point == nullptr) {
+      std::this_thread::yield();
+      thread.idle_time += Clock::now() - idle_start;
+      continue;
+    }
 
-  // Initialize the best move
-  if (depth == local_depth_) {
-    successors[0].set_heuristic_value(EvaluateHeuristic(successors[0], color,
-        capture_only));
+    --idle_threads_;
+    HelpAtSplitPoint(thread, *split_point);
+    ++idle_threads_;
+  }
+
+  --idle_threads_;
+}
 
-    if (best_move_.heuristic_value() == -float_max_
-        || successors[0].heuristic_value() > best_move_.heuristic_value())
-      best_move_ = successors[0];
+/// Only the younger brothers of a node are split, once the eldest has shown
+/// what the node is worth. Nodes near the root are left to the owner, since
+/// the root moves and the immediate win check are handled there, and nodes
+/// near the leaves have too little work under them to share.
+///
+bool TzaarGame::CanSplit(const SearchThread &thread, int depth,
+    const Move *next, const Move *end) const {
+  return parallel_search_ == wtps::kYoungBrothersWait
+      && threads_.size() > 1
+      && thread.root_depth - depth >= 2
+      && depth >= kMinSplitDepth
+      && end - next >= 2
+      && idle_threads_.load(std::memory_order_relaxed) > 0;
+}
+
+/// The split point lives on the owner's stack, so the owner must not return
+/// before every thread that joined it has left. Once its own share of the
+/// children is done, it takes the split point out of its queue so that no
+/// more threads join, and waits for the others to finish theirs. While it
+/// waits, it helps at the split points the others made below its own, whose
+/// work it is waiting for; only the time with nothing to help with is idle.
+///
+void TzaarGame::Split(SearchThread &thread, const Move *first,
+    const Move *last, int depth, float &alpha, float &beta, Move &best_move) {
+  int ply = thread.root_depth - depth;
+  SplitPoint split_point(thread.state);
+  split_point.parent = thread.split_point;
+  split_point.depth = depth;
+  split_point.ply = ply;
+  split_point.root_depth = thread.root_depth;
+  split_point.maximizing = thread.state.color_to_move() == player_color_;
+  split_point.moves = first;
+  split_point.moves_end = last;
+  split_point.alpha = alpha;
+  split_point.beta = beta;
+  split_point.best_move = best_move;
+
+  SplitQueue &queue = split_queues_[thread.id];
+  {
+    std::lock_guard<std::mutex> lock(queue.lock);
+    queue.split_points.push_back(&split_point);
   }
+  ++thread.splits;
+
+  WorkAtSplitPoint(thread, split_point);
+
+  {
+    std::lock_guard<std::mutex> lock(queue.lock);
+    queue.split_points.pop_back();
+  }
+
+  bool helped = false;
+  for (;;) {
+    {
+      std::lock_guard<std::mutex> lock(split_point.lock);
+      if (split_point.workers == 0)
+        break;
+    }
+
+    Clock::time_point idle_start = Clock::now();
+    SplitPoint *below = StealSplitPoint(thread, &split_point);
+    if (below == nullptr) {
+      std::this_thread::yield();
+      thread.idle_time += Clock::now() - idle_start;
+      continue;
+    }
+
+    HelpAtSplitPoint(thread, *below);
+    helped = true;
+  }
+
+  // Helping left the thread in another state
+  if (helped)
+    thread.state = split_point.state;
+
+  alpha = split_point.alpha;
+  beta = split_point.beta;
+
+  if (split_point.best_move != best_move) {
+    best_move = split_point.best_move;
+    for (int i = ply; i < split_point.pv_length; ++i)
+      thread.pv[ply][i] = split_point.pv[i];
+    thread.pv_length[ply] = split_point.pv_length;
+  }
+
+  if (split_point.cutoff) {
+    RecordCutoff(thread, best_move, ply, depth);
+    WARTZAAR_STAT(thread.stats, cutoffs);
+  }
+}
+
+/// Split points are taken from the front of each queue, nearest the root.
+/// A thread joins a split point while holding the lock of its queue, so the
+/// owner cannot take it out of the queue and stop waiting in between. A
+/// split point's ancestors outlive it, so its parents can be followed while
+/// it is in the queue.
+///
+SplitPoint* TzaarGame::StealSplitPoint(SearchThread &thread,
+    const SplitPoint *ancestor) {
+  for (size_t i = 0; i < split_queues_.size(); ++i) {
+    if (static_cast<int>(i) == thread.id)
+      continue;
+
+    SplitQueue &queue = split_queues_[i];
+    std::lock_guard<std::mutex> queue_lock(queue.lock);
+
+    for (size_t j = 0; j < queue.split_points.size(); ++j) {
+      SplitPoint *split_point = queue.split_points[j];
+
+      if (ancestor != nullptr) {
+        const SplitPoint *parent = split_point->parent;
+        while (parent != nullptr && parent != ancestor)
+          parent = parent->parent;
+        if (parent == nullptr)
+          continue;
+      }
+
+      std::lock_guard<std::mutex> lock(split_point->lock);
+
+      if (split_point->moves != split_point->moves_end
+          && !split_point->cutoff) {
+        ++split_point->workers;
+        ++thread.steals;
+        return split_point;
+      }
+    }
+  }
+
+  return nullptr;
+}
+
+void TzaarGame::HelpAtSplitPoint(SearchThread &thread,
+    SplitPoint &split_point) {
+  thread.state = split_point.state;
+  thread.root_depth = split_point.root_depth;
+  thread.follow_pv = false;
+  WorkAtSplitPoint(thread, split_point);
+
+  std::lock_guard<std::mutex> lock(split_point.lock);
+  --split_point.workers;
+}
+
+/// Every child searched here is a younger brother, so each is searched with
+/// a scout window against the bounds shared at the time it is taken, and
+/// searched again with the full window if it beats them. The bounds may have
+/// narrowed by the time the result comes back, so it is checked against them
+/// again under the lock.
+///
+void TzaarGame::WorkAtSplitPoint(SearchThread &thread,
+    SplitPoint &split_point) {
+  SplitPoint *parent = thread.split_point;
+  thread.split_point = &split_point;
+
+  GameState &state = thread.state;
+  int depth = split_point.depth;
+  int ply = split_point.ply;
+  UndoRecord undo;
+
+  for (;;) {
+    Move move;
+    float alpha;
+    float beta;
+    {
+      std::lock_guard<std::mutex> lock(split_point.lock);
+      if (split_point.moves == split_point.moves_end || split_point.cutoff)
+        break;
+
+      move = *split_point.moves++;
+      alpha = split_point.alpha;
+      beta = split_point.beta;
+    }
+
+    state.MakeMove(move, undo);
+    thread.pv_length[ply + 1] = ply + 1;
+
+    float value;
+    if (split_point.maximizing) {
+      if (alpha == -float_max_) {
+        value = Minimax(thread, depth - 1, alpha, beta);
+      }
+      else {
+        value = Minimax(thread, depth - 1, alpha, alpha + kScoutWindow);
+        if (value > alpha && value < beta)
+          value = Minimax(thread, depth - 1, alpha, beta);
+      }
+    }
+    else {
+      if (beta == float_max_) {
+        value = Minimax(thread, depth - 1, alpha, beta);
+      }
+      else {
+        value = Minimax(thread, depth - 1, beta - kScoutWindow, beta);
+        if (value < beta && value > alpha)
+          value = Minimax(thread, depth - 1, alpha, beta);
+      }
+    }
+
+    state.UnmakeMove(undo);
+
+    if (Aborted(thread))
+      break;
+
+    std::lock_guard<std::mutex> lock(split_point.lock);
+    bool improved = split_point.maximizing ? value > split_point.alpha
+                                           : value < split_point.beta;
+    if (improved) {
+      if (split_point.maximizing)
+        split_point.alpha = value;
+      else
+        split_point.beta = value;
+
+      split_point.best_move = move;
+      split_point.pv[ply] = move;
+      for (int i = ply + 1; i < thread.pv_length[ply + 1]; ++i)
+        split_point.pv[i] = thread.pv[ply + 1][i];
+      split_point.pv_length = (std::max)(ply + 1, thread.pv_length[ply + 1]);
+
+      if (split_point.alpha >= split_point.beta)
+        split_point.cutoff = true;
+    }
+  }
+
+  thread.split_point = parent;
+}
+
+/// Each iteration after the second starts with an aspiration window around the
+/// score of the iteration two plies shallower. The score swings widely
+/// between odd and even depths, as the two moves of a turn end up split
+/// between iterations, but it seldom moves far between depths of the same
+/// parity. When the score falls outside the window, the side it failed on is
+/// widened and the iteration is searched again; the transposition table and
+/// move ordering keep the repeated search cheap.
+///
+void TzaarGame::SearchRoot(SearchThread &thread) {
+  int depth = thread.root_depth;
+  float score = depth > 2 ? thread.iteration_scores[depth - 2] : 0.0f;
+  float delta = kAspirationWindow;
+  float alpha = -float_max_;
+  float beta = float_max_;
+
+  if (depth > 2 && score > -float_max_ && score < float_max_) {
+    alpha = score - delta;
+    beta = score + delta;
+  }
+
+  for (;;) {
+    thread.follow_pv = true;
+    float value = Minimax(thread, depth, alpha, beta);
+
+    if (Stopped())
+      break;
+
+    delta *= 4.0f;
+    if (value <= alpha && alpha > -float_max_)
+      alpha = delta > kMaxAspirationWindow ? -float_max_ : score - delta;
+    else if (value >= beta && beta < float_max_)
+      beta = delta > kMaxAspirationWindow ? float_max_ : score + delta;
+    else
+      break;
+  }
+}
+
+/// The stop flag is checked every time, but the limits are only polled once
+/// the thread has searched another TimeManager::kPollInterval nodes, or the
+/// main thread has reached the node limit.
+///
+bool TzaarGame::Aborted(SearchThread &thread) {
+  if (stop_.load(std::memory_order_relaxed))
+    return true;
+
+  uint64_t nodes = thread.nodes + thread.qsearch_nodes;
+  if (nodes >= thread.next_poll) {
+    thread.next_poll = time_manager_.NextPoll(nodes);
+    if (thread.id == 0 && time_manager_.NodeLimitReached(nodes))
+      stop_ = true;
+    if (Stopped())
+      return true;
+  }
+
+  for (const SplitPoint *split_point = thread.split_point;
+       split_point != nullptr; split_point = split_point->parent)
+    if (split_point->cutoff.load(std::memory_order_relaxed))
+      return true;
+
+  return false;
+}
+
+/// The search runs on a single mutable state: each successor is made in place
+/// with GameState::MakeMove and taken back with UnmakeMove before the next one
+/// is tried, so the state is unchanged when Minimax returns. The state also
+/// tracks whose move it is, and whether it is the first or second move of the
+/// turn, so the turn structure is followed by GameState::MakeMove.
+///
+/// Results are cached in the transposition table by the state's Zobrist key.
+/// A stored result that was searched at least as deep as needed ends the
+/// search of a state early when its bound allows; otherwise its best move is
+/// searched first. Results of a search cut short by the clock are not stored.
+///
+/// This is a principal variation search. The first successor of a node is
+/// expected to be the best, and is searched with the full window. Each of the
+/// others is first searched with a window just wide enough to tell whether it
+/// is better, and searched again with the full window only if it is.
+///
+float TzaarGame::Minimax(SearchThread &thread, int depth, float alpha,
+    float beta) {
+  GameState &state = thread.state;
+  wtc::Color color = state.color_to_move();
+  bool capture_only = state.capture_only();
+  int ply = thread.root_depth - depth;
+  thread.pv_length[ply] = ply;
+  ++thread.nodes;
+
+  // Bail out if we're out of time. Like every value in this search, leaves
+  // are scored from our point of view, whoever is to move.
+  if (Aborted(thread)) {
+    WARTZAAR_STAT(thread.stats, evaluations);
+    return EvaluateHeuristic(state, player_color_, capture_only);
+  }
+
+  // Settle the captures at the depth limit before scoring the state
+  if (depth == 0)
+    return Quiesce(thread, qsearch_depth_, alpha, beta);
+
+  // Look for a stored result. The root is always searched, so that a best
+  // move is found.
+  TranspositionEntry entry;
+  Move hash_move;
+  WARTZAAR_STAT(thread.stats, tt_probes);
+  if (transposition_table_.Probe(state.hash(), entry)) {
+    WARTZAAR_STAT(thread.stats, tt_hits);
+    hash_move = TranspositionTable::EntryMove(entry);
+
+    if (depth < thread.root_depth && entry.depth >= depth) {
+      TranspositionTable::Bound bound = TranspositionTable::EntryBound(entry);
+
+      if (bound == TranspositionTable::kExact
+          || (bound == TranspositionTable::kLowerBound && entry.score >= beta)
+          || (bound == TranspositionTable::kUpperBound && entry.score <= alpha)) {
+        WARTZAAR_STAT(thread.stats, tt_cutoffs);
+        return entry.score;
+      }
+    }
+  }
+
+  // Get successor moves. The root moves were generated once, and are already
+  // in order.
+  MoveList successors;
+  if (ply == 0) {
+    successors = thread.root_moves;
+  }
+  else {
+    MoveGenerator::GenerateMoves(state, color, capture_only, successors);
+
+    // The second move of a turn may be passed
+    if (!capture_only)
+      successors.Add(Move::Pass());
+  }
+
+  // Bail out if this is a terminal (leaf) state
+  if (successors.empty()) {
+    WARTZAAR_STAT(thread.stats, evaluations);
+    return EvaluateHeuristic(state, player_color_, capture_only);
+  }
+
+  // Search the most promising moves first
+  if (ply > 0)
+    OrderMoves(thread, successors, ply, hash_move);
+
+  float alpha_orig = alpha;
+  float beta_orig = beta;
+  Move node_best_move;
+  UndoRecord undo;
+
+  // Have a move to make even if the clock runs out before any is searched.
+  // The root moves are sorted, so the first is the best of the last iteration.
+  if (ply == 0 && thread.best_move.IsNull())
+    thread.best_move = successors[0];
 
   // Maximizing player's turn (ours)
+  float result;
   int successors_passed = 0;
   if (player_color_ == color) {
-    std::vector<GameState>::iterator successor_itr = successors.begin();
-    while (successor_itr != successors.end() && clock() < turn_move_timeout_ && successors_passed <= beam_size_) {
-
-//      std::cout << "Evaluating child " << successors_passed + 1 << "/" << successors.size()
-//                << " (" << successor_itr->ToString() << ")" << std::endl;
+    const Move *successor_itr = successors.begin();
+    while (successor_itr != successors.end() && !Aborted(thread) && successors_passed <= beam_size_) {
+      state.MakeMove(*successor_itr, undo);
 
       float value = -float_max_;
 
@@ -144,165 +893,456 @@ float TzaarGame::Minimax(GameState &state, int depth, float alpha, float beta,
       // winning state.
       //
       // If it's the first move of the game, or this player has sent both moves,
-      // the turn is over, and we need to call minimax for the opposite player
-      // with capture_only = true.
-      //
-      // Otherwise, it's the first move of the turn, and we need to call minimax
-      // for the same player with capture_only = false.
+      // the turn is over, and the next move is the opposite player's capture.
+      // Otherwise, it's the first move of the turn, and the next move is the
+      // same player's capture-or-stack.
       //
-      if (depth >= local_depth_ - 1)
-        value = EvaluateHeuristic(*successor_itr, color, capture_only);
+      if (depth >= thread.root_depth - 1) {
+        WARTZAAR_STAT(thread.stats, win_checks);
+        value = EvaluateHeuristic(state, color, capture_only);
+      }
 
+      thread.pv_length[ply + 1] = ply + 1;
       if (value < float_max_) {
-        if ((turn_count_ == 0 && depth == local_depth_) || !capture_only) {
-  //        std::cout << "MAX player calling Minimax(" << successor_itr->ToString() << ", " << depth - 1 << ", opponent, capture_only)" << std::endl;
-          value = Minimax(*successor_itr, depth - 1, alpha, beta, OppositeColor(color), true);
+        if (successor_itr == successors.begin() || alpha == -float_max_) {
+          value = Minimax(thread, depth - 1, alpha, beta);
         }
         else {
-  //        std::cout << "MAX player calling Minimax(" << successor_itr->ToString() << ", " << depth - 1 << ", self, !capture_only)" << std::endl;
-          value = Minimax(*successor_itr, depth - 1, alpha, beta, color, false);
+          value = Minimax(thread, depth - 1, alpha, alpha + kScoutWindow);
+          if (value > alpha && value < beta)
+            value = Minimax(thread, depth - 1, alpha, beta);
+        }
+
+        // A search cut short by the stop scored its leaves as they stood, so
+        // its score is not used, and the best move so far is kept
+        if (Aborted(thread)) {
+          state.UnmakeMove(undo);
+          break;
         }
       }
 
-      if (value > alpha || (depth >= local_depth_ - 1 && value == float_max_)) {
-        alpha = value;
+      // Only the first successor can be on the principal variation
+      thread.follow_pv = false;
 
-        if (depth >= local_depth_ - 1 && value == float_max_)
-          successor_itr->set_heuristic_value(float_max_);
-        else
-          successor_itr->set_heuristic_value(EvaluateHeuristic(*successor_itr,
-              color, capture_only));
+      // Only a move that raises alpha has a true score. The others only
+      // failed low, and keep their order behind it.
+      if (ply == 0)
+        thread.root_scores[successor_itr - successors.begin()] =
+            value > alpha ? value : -float_max_;
 
-        if (depth == local_depth_
-            && successor_itr->heuristic_value() > best_move_.heuristic_value())
-          best_move_ = *successor_itr;
+      if (value > alpha) {
+        alpha = value;
+        node_best_move = *successor_itr;
+        UpdatePv(thread, ply, node_best_move);
+
+        if (ply == 0) {
+          thread.best_move = node_best_move;
+          thread.best_value = value;
+        }
       }
 
-      if (alpha >= beta) break;  // beta cutoff
+      state.UnmakeMove(undo);
+
+      if (alpha >= beta) {  // beta cutoff
+        RecordCutoff(thread, *successor_itr, ply, depth);
+        WARTZAAR_STAT(thread.stats, cutoffs);
+        if (successors_passed == 0)
+          WARTZAAR_STAT(thread.stats, first_move_cutoffs);
+        break;
+      }
 
       ++successor_itr;
       ++successors_passed;
+
+      // Once the eldest brother has been searched, the younger ones may be
+      // searched in parallel
+      if (successors_passed == 1
+          && parallel_search_ == wtps::kYoungBrothersWait) {
+        const Move *last = successor_itr + (std::min)(
+            static_cast<int>(successors.end() - successor_itr), beam_size_);
+
+        if (CanSplit(thread, depth, successor_itr, last)) {
+          Split(thread, successor_itr, last, depth, alpha, beta,
+              node_best_move);
+          break;
+        }
+      }
     }
 
-    return alpha;
+    result = alpha;
   }
   // Minimizing player's turn (opponent's)
   else {
-    std::vector<GameState>::iterator successor_itr = successors.begin();
-    while (successor_itr != successors.end() && clock() < turn_move_timeout_ && successors_passed <= beam_size_) {
-      // If it's the first move of the turn, call minimax for the same player
-      // with capture_only = false.
-      //
-      // Otherwise, this player has sent both moves, and we need to call minimax
-      // for the opposite player with capture_only = true.
+    const Move *successor_itr = successors.begin();
+    while (successor_itr != successors.end() && !Aborted(thread) && successors_passed <= beam_size_) {
+      state.MakeMove(*successor_itr, undo);
+
+      // If it's the first move of the turn, the next move is the same
+      // player's capture-or-stack. Otherwise, this player has sent both moves,
+      // and the next move is the opposite player's capture.
       //
-      float value = -float_max_;
-      if (capture_only) {
-//        std::cout << "MIN player calling Minimax(" << successor_itr->ToString() << ", " << depth - 1 << ", self, !capture_only)" << std::endl;
-        value = Minimax(*successor_itr, depth - 1, alpha, beta, color, false);
+      float value;
+      if (successor_itr == successors.begin() || beta == float_max_) {
+        value = Minimax(thread, depth - 1, alpha, beta);
       }
       else {
-//        std::cout << "MIN player calling Minimax(" << successor_itr->ToString() << ", " << depth - 1 << ", opponent, capture_only)" << std::endl;
-        value = Minimax(*successor_itr, depth - 1, alpha, beta, OppositeColor(color), true);
+        value = Minimax(thread, depth - 1, beta - kScoutWindow, beta);
+        if (value < beta && value > alpha)
+          value = Minimax(thread, depth - 1, alpha, beta);
       }
+      thread.follow_pv = false;
+
+      state.UnmakeMove(undo);
 
-//      std::cout << "...value = " << value << std::endl;
+      if (Aborted(thread))
+        break;
 
-      if (value < beta) beta = value;
-      if (alpha >= beta) break;  // alpha cutoff
+      if (value < beta) {
+        beta = value;
+        node_best_move = *successor_itr;
+        UpdatePv(thread, ply, node_best_move);
+      }
+      if (alpha >= beta) {  // alpha cutoff
+        RecordCutoff(thread, *successor_itr, ply, depth);
+        WARTZAAR_STAT(thread.stats, cutoffs);
+        if (successors_passed == 0)
+          WARTZAAR_STAT(thread.stats, first_move_cutoffs);
+        break;
+      }
 
       ++successor_itr;
       ++successors_passed;
+
+      // Once the eldest brother has been searched, the younger ones may be
+      // searched in parallel
+      if (successors_passed == 1
+          && parallel_search_ == wtps::kYoungBrothersWait) {
+        const Move *last = successor_itr + (std::min)(
+            static_cast<int>(successors.end() - successor_itr), beam_size_);
+
+        if (CanSplit(thread, depth, successor_itr, last)) {
+          Split(thread, successor_itr, last, depth, alpha, beta,
+              node_best_move);
+          break;
+        }
+      }
     }
 
-    return beta;
+    result = beta;
   }
-}
 
-int TzaarGame::CountSuccessors(const GameState &from_state,
-    wtc::Color color, bool capture_only) const {
-  int count = 0;
-  std::vector< std::vector<GameBoardPosition> >::const_iterator col_itr;
+  // Store the result, unless the search was stopped part way through
+  if (!Aborted(thread)) {
+    TranspositionTable::Bound bound = TranspositionTable::kExact;
+    if (result <= alpha_orig)
+      bound = TranspositionTable::kUpperBound;
+    else if (result >= beta_orig)
+      bound = TranspositionTable::kLowerBound;
 
-  for (col_itr = from_state.BeginConst(); col_itr != from_state.EndConst(); ++col_itr) {
-    std::vector<GameBoardPosition>::const_iterator row_itr;
+    transposition_table_.Store(state.hash(), depth, bound, result,
+        node_best_move);
+  }
+
+  return result;
+}
 
-    for (row_itr = col_itr->begin(); row_itr != col_itr->end(); ++row_itr) {
-      // Skip empty positions and opponent positions
-      if (row_itr->stack_height() == 0
-          || (row_itr->color() != 0 && *(row_itr->color()) != color))
+/// Only captures are searched, so the search ends quickly. Either player may
+/// also stand pat: decline to capture and take the static score of the state,
+/// which bounds the value of the node. Captures that could not reach the
+/// window even at their full worth are skipped. The search stops after depth
+/// plies of captures, where the state is scored as it is.
+///
+float TzaarGame::Quiesce(SearchThread &thread, int depth, float alpha,
+    float beta) {
+  GameState &state = thread.state;
+  ++thread.qsearch_nodes;
+
+  WARTZAAR_STAT(thread.stats, evaluations);
+  float stand_pat = EvaluateHeuristic(state, player_color_,
+      state.capture_only());
+  if (depth == 0 || stand_pat == float_max_ || stand_pat == -float_max_)
+    return stand_pat;
+
+  bool maximizing = state.color_to_move() == player_color_;
+  if (maximizing) {
+    if (stand_pat >= beta)
+      return stand_pat;
+    alpha = (std::max)(alpha, stand_pat);
+  }
+  else {
+    if (stand_pat <= alpha)
+      return stand_pat;
+    beta = (std::min)(beta, stand_pat);
+  }
+
+  // The first capture of a turn is followed by a second one
+  float second_gain = state.capture_only() ? SecondCaptureGain(state) : 0.0f;
+  MoveList captures;
+  MoveGenerator::GenerateMoves(state, state.color_to_move(), true, captures);
+
+  // Try the captures of the scarcest pieces first
+  int scores[MoveList::kMaxMoves];
+  for (int i = 0; i < captures.size(); ++i)
+    scores[i] = CaptureScore(state, captures[i].to_cell());
+
+  UndoRecord undo;
+  for (int i = 0; i < captures.size(); ++i) {
+    int best = i;
+    for (int j = i + 1; j < captures.size(); ++j)
+      if (scores[j] > scores[best])
+        best = j;
+    std::swap(captures[i], captures[best]);
+    std::swap(scores[i], scores[best]);
+
+    // Skip captures that cannot bring the score back inside the window, even
+    // if they take all that the captured stack is worth, and the most a
+    // second capture of the turn could add. Whether a capture can end the
+    // game costs far more to find out, so it is only asked of the captures
+    // the bound would skip.
+    if (second_gain < float_max_) {
+      float gain = CaptureGain(state, captures[i].to_cell()) + second_gain;
+      if ((maximizing ? stand_pat + gain <= alpha : stand_pat - gain >= beta)
+          && !CaptureCanEndGame(state, captures[i]))
         continue;
+    }
 
-      // Search for possible moves in each direction
-      for (size_t i = 0; i < directions_.size(); ++i) {
-        GameBoardPosition *pos = row_itr->SearchPath(directions_[i]);
+    state.MakeMove(captures[i], undo);
+    float value = Quiesce(thread, depth - 1, alpha, beta);
+    state.UnmakeMove(undo);
 
-        // Check for capturing move
-        if (pos != 0 && color != *(pos->color())
-            && row_itr->stack_height() >= pos->stack_height())
-          ++count;
+    if (maximizing)
+      alpha = (std::max)(alpha, value);
+    else
+      beta = (std::min)(beta, value);
 
-        // Check for stacking move
-        if (pos != 0 && *(pos->color()) == color && capture_only == false
-            && from_state.GetPieceCount(color, *(pos->type())) > 1)
-          ++count;
-      }
+    if (alpha >= beta)
+      break;
+  }
+
+  return maximizing ? alpha : beta;
+}
+
+/// Taking the last piece of a type wins the game, so its gain is unbounded.
+/// Otherwise the captured player loses one piece of the type, and the height
+/// of the captured stack above its bottom piece from the adjusted stack height
+/// of the type.
+///
+float TzaarGame::CaptureGain(const GameState &state, int to_cell) const {
+  const GameBoard &board = state.board();
+  wtc::Color color = board.ColorAt(to_cell);
+  wtpt::PieceType piece_type = board.TypeAt(to_cell);
+  int count = state.GetPieceCount(color, piece_type);
+  if (count <= 1)
+    return float_max_;
+
+  int type = piece_type - 1;
+  int height = state.GetStackHeight(color, piece_type);
+  return material_value_[type][count] - material_value_[type][count - 1]
+       + stack_value_[type][height]
+       - stack_value_[type][height - (board.StackHeightAt(to_cell) - 1)];
+}
+
+/// The second capture takes a stack of one of the opponent's types, from a
+/// count at least one lower than now, and a material step only grows as the
+/// count falls. The captured stack takes at most the whole adjusted stack
+/// height of its type. Either capture can take up to
+/// GameState::kMaxCapturesInvolving captures from a player, and the game can
+/// end if that leaves none.
+///
+float TzaarGame::SecondCaptureGain(const GameState &state) const {
+  if (state.GetCaptureCount(wtc::kWhite)
+          <= 2 * GameState::kMaxCapturesInvolving
+      || state.GetCaptureCount(wtc::kBlack)
+          <= 2 * GameState::kMaxCapturesInvolving)
+    return float_max_;
+
+  wtc::Color color = OppositeColor(state.color_to_move());
+  float gain = 0.0f;
+
+  for (int type = 0; type < 3; ++type) {
+    wtpt::PieceType piece_type = static_cast<wtpt::PieceType>(type + 1);
+    int count = state.GetPieceCount(color, piece_type);
+    if (count <= 2)
+      return float_max_;
+
+    gain = (std::max)(gain,
+        material_value_[type][count - 1] - material_value_[type][count - 2]
+        + stack_value_[type][state.GetStackHeight(color, piece_type)]);
+  }
+
+  return gain;
+}
+
+/// A player can only run out of captures if it has no more than those
+/// involving the two stacks of the move. Those are only counted when the
+/// player has few enough captures for it to matter.
+///
+bool TzaarGame::CaptureCanEndGame(const GameState &state,
+    const Move &move) const {
+  if (state.GetCaptureCount(wtc::kWhite) > GameState::kMaxCapturesInvolving
+      && state.GetCaptureCount(wtc::kBlack) > GameState::kMaxCapturesInvolving)
+    return false;
+
+  int from_cell = move.from_cell();
+  int to_cell = move.to_cell();
+
+  return state.GetCaptureCount(wtc::kWhite)
+             <= state.CountCapturesInvolving(from_cell, to_cell, wtc::kWhite)
+      || state.GetCaptureCount(wtc::kBlack)
+             <= state.CountCapturesInvolving(from_cell, to_cell, wtc::kBlack);
+}
+
+/// Successors are searched in stages:
+///   - the principal variation move, for nodes on the principal variation of
+///     the last iteration
+///   - the move stored in the transposition table
+///   - captures, of the scarcest piece types and then the tallest stacks
+///     first
+///   - the two killer moves of this ply
+///   - the remaining stacking moves, by their history score
+///
+/// The first successor searched from a node on the principal variation is its
+/// principal variation move, so following it leads down the line.
+///
+void TzaarGame::OrderMoves(SearchThread &thread, MoveList &successors,
+    int ply, const Move &hash_move) {
+  const GameState &state = thread.state;
+  Move pv_move;
+  if (thread.follow_pv) {
+    thread.follow_pv = false;
+    if (ply < thread.previous_pv_length)
+      pv_move = thread.previous_pv[ply];
+  }
+
+  int scores[MoveList::kMaxMoves];
+
+  for (int i = 0; i < successors.size(); ++i) {
+    const Move &move = successors[i];
+
+    if (!pv_move.IsNull() && move == pv_move) {
+      scores[i] = kPvMoveScore;
+      thread.follow_pv = true;
     }
+    else if (!hash_move.IsNull() && move == hash_move)
+      scores[i] = kHashMoveScore;
+    else if (move.capture())
+      scores[i] = kCaptureScore + CaptureScore(state, move.to_cell());
+    else if (move.IsPass())
+      scores[i] = -1;
+    else if (move == thread.killers[ply][0])
+      scores[i] = kKillerScore + 1;
+    else if (move == thread.killers[ply][1])
+      scores[i] = kKillerScore;
+    else
+      scores[i] = thread.history[move.from_cell()][move.to_cell()];
   }
 
-  return count;
+  // A stable insertion sort keeps moves with equal scores in board order
+  for (int i = 1; i < successors.size(); ++i) {
+    Move move = successors[i];
+    int score = scores[i];
+    int j = i;
 
+    while (j > 0 && scores[j - 1] < score) {
+      successors[j] = successors[j - 1];
+      scores[j] = scores[j - 1];
+      --j;
+    }
+
+    successors[j] = move;
+    scores[j] = score;
+  }
 }
 
-/// A capturing move can be made in a given direction if:
-///   - The next link is not null
-///   - The next cell has one or more pieces in it
-///   - The stack in the next cell belongs to the opponent
-///   - The size of the stack in the next cell is equal to or smaller than
-///     ours
+/// Losing the last piece of any type loses the game, so captures of the
+/// opponent's scarcest piece types come first. Among those, taller stacks are
+/// captured first.
 ///
-/// A stacking move can be made in a given direction if:
-///   - The next link is not null
-///   - The next cell has one or more pieces in it
-///   - The stack in the next cell belongs to us
-///   - There are at least 2 of the destination piece type left on the board
+int TzaarGame::CaptureScore(const GameState &state, int to_cell) const {
+  const GameBoard &board = state.board();
+  int count = state.GetPieceCount(board.ColorAt(to_cell),
+      board.TypeAt(to_cell));
+
+  return (kMaxPieceCount + 1 - count) * (kMaxStackHeight + 1)
+       + board.StackHeightAt(to_cell);
+}
+
+/// A stacking move that causes a cutoff becomes the first killer move of its
+/// ply, and its history score grows with the depth it was searched to.
+/// Captures are already searched early, so they are left out, and so are
+/// passes.
 ///
-std::vector<GameState> TzaarGame::FindSuccessors(const GameState &from_state,
-    wtc::Color color, bool capture_only) const {
-  std::vector<GameState> successors;
-  std::vector< std::vector<GameBoardPosition> >::const_iterator col_itr;
+void TzaarGame::RecordCutoff(SearchThread &thread, const Move &move, int ply,
+    int depth) {
+  if (move.capture() || move.IsPass())
+    return;
+
+  if (move != thread.killers[ply][0]) {
+    thread.killers[ply][1] = thread.killers[ply][0];
+    thread.killers[ply][0] = move;
+  }
 
-  for (col_itr = from_state.BeginConst(); col_itr != from_state.EndConst(); ++col_itr) {
-    std::vector<GameBoardPosition>::const_iterator row_itr;
+  int &history = thread.history[move.from_cell()][move.to_cell()];
+  history += depth * depth;
 
-    for (row_itr = col_itr->begin(); row_itr != col_itr->end(); ++row_itr) {
-      // Skip empty positions and opponent positions
-      if (row_itr->stack_height() == 0
-          || (row_itr->color() != 0 && *(row_itr->color()) != color))
-        continue;
+  // Keep history scores below the killer moves
+  if (history >= kKillerScore)
+    AgeHistory(thread);
+}
 
-      // Search for possible moves in each direction
-      for (size_t i = 0; i < directions_.size(); ++i) {
-        GameBoardPosition *pos = row_itr->SearchPath(directions_[i]);
+void TzaarGame::AgeHistory(SearchThread &thread) {
+  for (int from = 0; from < GameBoard::kNumCells; ++from)
+    for (int to = 0; to < GameBoard::kNumCells; ++to)
+      thread.history[from][to] /= 2;
+}
 
-        // Check for capturing move
-        if (pos != 0 && color != *(pos->color())
-            && row_itr->stack_height() >= pos->stack_height()) {
-          successors.push_back(GameState(from_state));
-          successors.back().MakeMove(row_itr->col(), row_itr->row(), pos->col(), pos->row());
-        }
+/// A stable insertion sort keeps moves with equal scores in their last order.
+/// Moves that were not searched keep their -infinity score and go last.
+///
+void TzaarGame::SortRootMoves(SearchThread &thread) {
+  MoveList &root_moves = thread.root_moves;
+  float *root_scores = thread.root_scores;
+
+  for (int i = 1; i < root_moves.size(); ++i) {
+    Move move = root_moves[i];
+    float score = root_scores[i];
+    int j = i;
+
+    while (j > 0 && root_scores[j - 1] < score) {
+      root_moves[j] = root_moves[j - 1];
+      root_scores[j] = root_scores[j - 1];
+      --j;
+    }
 
-        // Check for stacking move
-        if (pos != 0 && *(pos->color()) == color && capture_only == false
-            && from_state.GetPieceCount(color, *(pos->type())) > 1) {
-          successors.push_back(GameState(from_state));
-          successors.back().MakeMove(row_itr->col(), row_itr->row(), pos->col(), pos->row());
+    root_moves[j] = move;
+    root_scores[j] = score;
+  }
+
+  // Put the principal variation move first
+  if (thread.previous_pv_length > 0) {
+    for (int i = 1; i < root_moves.size(); ++i) {
+      if (root_moves[i] == thread.previous_pv[0]) {
+        Move move = root_moves[i];
+        float score = root_scores[i];
+        for (int j = i; j > 0; --j) {
+          root_moves[j] = root_moves[j - 1];
+          root_scores[j] = root_scores[j - 1];
         }
+        root_moves[0] = move;
+        root_scores[0] = score;
+        break;
       }
     }
   }
+}
+
+void TzaarGame::UpdatePv(SearchThread &thread, int ply, const Move &move) {
+  thread.pv[ply][ply] = move;
+
+  for (int i = ply + 1; i < thread.pv_length[ply + 1]; ++i)
+    thread.pv[ply][i] = thread.pv[ply + 1][i];
 
-  return successors;
+  thread.pv_length[ply] = (std::max)(ply + 1, thread.pv_length[ply + 1]);
 }
 
 /// ----------------------------------------------------------------------------
@@ -324,6 +1364,9 @@ std::vector<GameState> TzaarGame::FindSuccessors(const GameState &from_state,
 /// A very bad state:
 ///   ln(1 - 0.9) = -2.30258509
 ///
+/// The difference between the two players' weighted counts is the material
+/// term.
+///
 /// ----------------------------------------------------------------------------
 /// Stack height heuristic: Higher stacks are more powerful and protect the top
 /// pieces better than if they were on their own.
@@ -332,86 +1375,130 @@ std::vector<GameState> TzaarGame::FindSuccessors(const GameState &from_state,
 /// of one piece type. The stack height is adjusted so that single pieces do not
 /// skew the heuristic, thus the stack height at game start is zero.
 ///
-float TzaarGame::EvaluateHeuristic(GameState state, wtc::Color color,
-    bool capture_only) {
+/// Each piece type is weighted by the natural log of its adjusted stack height
+/// plus one, and the stack term is the difference between the two players'
+/// weighted heights, divided by the stack coefficient.
+///
+/// Both terms are looked up in the tables built by BuildEvaluationTables, so
+/// a leaf costs a few loads and adds.
+///
+float TzaarGame::EvaluateHeuristic(const GameState &state, wtc::Color color,
+    bool capture_only) const {
+  wtc::Color opponent = OppositeColor(color);
   float hval = 0.0f; // heuristic value
+  bool lost = false;
 
-  int white_tzaars  = state.GetPieceCount(wtc::kWhite, wtpt::kTzaar);
-  int white_tzarras = state.GetPieceCount(wtc::kWhite, wtpt::kTzarra);
-  int white_totts   = state.GetPieceCount(wtc::kWhite, wtpt::kTott);
-  int black_tzaars  = state.GetPieceCount(wtc::kBlack, wtpt::kTzaar);
-  int black_tzarras = state.GetPieceCount(wtc::kBlack, wtpt::kTzarra);
-  int black_totts   = state.GetPieceCount(wtc::kBlack, wtpt::kTott);
-
-  // Calculate a combined weighted piece count value
-  float white_count = tzaar_coefficient_  * ln_[white_tzaars]
-                    + tzarra_coefficient_ * ln_[white_tzarras]
-                    + tott_coefficient_   * ln_[white_totts];
-  float black_count = tzaar_coefficient_  * ln_[black_tzaars]
-                    + tzarra_coefficient_ * ln_[black_tzarras]
-                    + tott_coefficient_   * ln_[black_totts];
-
-  // Check for end-of-game scenarios
-  if (color == wtc::kWhite) {
-    if (black_tzaars < 1 || black_tzarras < 1 || black_totts < 1)
-      return float_max_;
-    else if (white_tzaars < 1 || white_tzarras < 1 || white_totts < 1)
-      return -float_max_;
-    else
-      hval += white_count - black_count;
-  }
-  else if (color == wtc::kBlack){
-    if (white_tzaars < 1 || white_tzarras < 1 || white_totts < 1)
+  for (int type = 0; type < 3; ++type) {
+    wtpt::PieceType piece_type = static_cast<wtpt::PieceType>(type + 1);
+    int own_count = state.GetPieceCount(color, piece_type);
+    int opponent_count = state.GetPieceCount(opponent, piece_type);
+
+    // Check for end-of-game scenarios
+    if (opponent_count < 1)
       return float_max_;
-    else if (black_tzaars < 1 || black_tzarras < 1 || black_totts < 1)
-      return -float_max_;
-    else
-      hval += black_count - white_count;
+    else if (own_count < 1)
+      lost = true;
+
+    hval += material_value_[type][own_count]
+          - material_value_[type][opponent_count]
+          + stack_value_[type][state.GetStackHeight(color, piece_type)]
+          - stack_value_[type][state.GetStackHeight(opponent, piece_type)];
   }
 
-  int white_tzaar_height  = state.GetStackHeight(wtc::kWhite, wtpt::kTzaar);
-  int white_tzarra_height = state.GetStackHeight(wtc::kWhite, wtpt::kTzarra);
-  int white_tott_height   = state.GetStackHeight(wtc::kWhite, wtpt::kTott);
-  int black_tzaar_height  = state.GetStackHeight(wtc::kBlack, wtpt::kTzaar);
-  int black_tzarra_height = state.GetStackHeight(wtc::kBlack, wtpt::kTzarra);
-  int black_tott_height   = state.GetStackHeight(wtc::kBlack, wtpt::kTott);
+  if (lost)
+    return -float_max_;
 
-  float white_height = tzaar_coefficient_  * log(white_tzaar_height  + 1.0f)
-                     + tzarra_coefficient_ * log(white_tzarra_height + 1.0f)
-                     + tott_coefficient_   * log(white_tott_height   + 1.0f);
-  float black_height = tzaar_coefficient_  * log(black_tzaar_height  + 1.0f)
-                     + tzarra_coefficient_ * log(black_tzarra_height + 1.0f)
-                     + tott_coefficient_   * log(black_tott_height   + 1.0f);
+  // Capturing moves available? The counts are kept up to date by the state.
+  if (state.GetCaptureCount(color) == 0) return -float_max_;
+  if (state.GetCaptureCount(opponent) == 0) return float_max_;
 
-//  float white_height = tzaar_coefficient_  * white_tzaar_height
-//                     + tzarra_coefficient_ * white_tzarra_height
-//                     + tott_coefficient_   * white_tott_height;
-//  float black_height = tzaar_coefficient_  * black_tzaar_height
-//                     + tzarra_coefficient_ * black_tzarra_height
-//                     + tott_coefficient_   * black_tott_height;
+  return hval;
+}
 
-  if (color == wtc::kWhite) {
-    hval += white_height - black_height;
-    hval *= white_count / white_height;
-  }
-  else if (color == wtc::kBlack){
-    hval += black_height - white_height;
-    hval *= black_count / black_height;
+void TzaarGame::BuildEvaluationTables() {
+  const int coefficient[3] = {
+    tott_coefficient_, tzarra_coefficient_, tzaar_coefficient_
+  };
+
+  for (int type = 0; type < 3; ++type) {
+    // A count of zero ends the game, so its value is never used
+    material_value_[type][0] = 0.0f;
+    for (int count = 1; count <= kMaxPieceCount; ++count)
+      material_value_[type][count] =
+          static_cast<float>(coefficient[type] * log(count - 0.9));
+
+    // A stack coefficient of zero leaves stacks out of the evaluation
+    for (int height = 0; height < kMaxStackHeight; ++height)
+      stack_value_[type][height] = stack_coefficient_ == 0 ? 0.0f
+          : static_cast<float>(
+              coefficient[type] * log(height + 1.0) / stack_coefficient_);
   }
+}
 
-  // Capturing moves available?
-  int moves = CountSuccessors(state, color, true);
-  if (moves == 0) return -float_max_;
+void TzaarGame::set_coefficients(int tzaar_coefficient, int tzarra_coefficient,
+    int tott_coefficient, int stack_coefficient) {
+  tzaar_coefficient_ = tzaar_coefficient;
+  tzarra_coefficient_ = tzarra_coefficient;
+  tott_coefficient_ = tott_coefficient;
+  stack_coefficient_ = stack_coefficient;
 
-  int oppmoves = CountSuccessors(state, OppositeColor(color), true);
-  if (oppmoves == 0) return float_max_;
+  BuildEvaluationTables();
 
-  return hval;
+  // Stored scores were computed with the old coefficients
+  StopPondering();
+  transposition_table_.Clear();
+}
+
+void TzaarGame::set_parallel_search(wtps::ParallelSearch parallel_search) {
+  StopPondering();
+  parallel_search_ = parallel_search;
+}
+
+void TzaarGame::set_quiet(bool quiet) {
+  quiet_ = quiet;
+}
+
+void TzaarGame::set_timed(bool timed) {
+  timed_ = timed;
+}
+
+void TzaarGame::set_node_limit(uint64_t node_limit) {
+  node_limit_ = node_limit;
+}
+
+uint64_t TzaarGame::search_nodes() const {
+  return search_nodes_;
+}
+
+void TzaarGame::set_ponder(bool ponder) {
+  StopPondering();
+  ponder_ = ponder;
+}
+
+float TzaarGame::Evaluate(const GameState &state) const {
+  return EvaluateHeuristic(state, player_color_, state.capture_only());
 }
 
 void TzaarGame::MakeMove(int from_column, int from_row, int to_column, int to_row) {
+  bool pondering = StopPondering();
+
   ++turn_count_;
   current_state_.MakeMove(from_column, from_row, to_column, to_row);
+
+  if (pondering)
+    StartPondering();
+}
+
+void TzaarGame::MakePass() {
+  bool pondering = StopPondering();
+
+  ++turn_count_;
+
+  UndoRecord undo;
+  current_state_.MakeMove(Move::Pass(), undo);
+
+  if (pondering)
+    StartPondering();
 }
 
 wtc::Color TzaarGame::OppositeColor(wtc::Color color) const {
@@ -446,6 +1533,7 @@ void TzaarGame::set_player_number(const std::string &player_number_string) {
 }
 
 void TzaarGame::set_current_state(const GameState &state) {
+  StopPondering();
   current_state_ = state;
 }
 
@@ -1,18 +1,28 @@
 #ifndef WARTZAAR_TZAAR_GAME_H_
 #define WARTZAAR_TZAAR_GAME_H_
 
-#include <time.h>  // for clock, CLOCKS_PER_SEC
+#include <stdint.h>
 
+#include <atomic>
+#include <chrono>
 #include <limits>
 #include <map>
 #include <queue>
+#include <thread>
 #include <vector>
 
+#include "wartzaar/clock.h"
 #include "wartzaar/game_state.h"
 #include "wartzaar/messages/move_message.h"
+#include "wartzaar/move.h"
 #include "wartzaar/priority_vector.h"
+#include "wartzaar/search_thread.h"
+#include "wartzaar/split_point.h"
+#include "wartzaar/time_manager.h"
+#include "wartzaar/transposition_table.h"
 #include "wartzaar/types/color.h"
 #include "wartzaar/types/direction.h"
+#include "wartzaar/types/parallel_search.h"
 #include "wartzaar/types/player_number.h"
 
 namespace wartzaar {
@@ -23,9 +33,13 @@ namespace wartzaar {
 class TzaarGame {
  public:
   /// Constructor.
-  TzaarGame(int turn_time, int max_depth, int beam_size, int tzaar_coefficient,
+  TzaarGame(int turn_time, int max_depth, int beam_size, int hash_mb,
+      int qsearch_depth, int threads, int tzaar_coefficient,
       int tzarra_coefficient, int tott_coefficient, int stack_coefficient);
 
+  /// Destructor stops pondering.
+  ~TzaarGame();
+
   /// Copy constructor and assignment operator are not supported.
   TzaarGame(const TzaarGame&);
   void operator=(const TzaarGame&);
@@ -33,9 +47,16 @@ class TzaarGame {
   /// This is the public interface for the AI search algorithm.
   wartzaar::messages::MoveMessage GetNextMove(bool capture_only);
 
+  /// Returns the heuristic score of the given state, from our point of view,
+  /// as the search scores its leaves.
+  float Evaluate(const GameState &state) const;
+
   /// Makes the given move on the current state.
   void MakeMove(int from_column, int from_row, int to_column, int to_row);
 
+  /// Passes the second move of the turn on the current state.
+  void MakePass();
+
   wartzaar::types::color::Color OppositeColor(wartzaar::types::color::Color color) const;
 
   void set_current_state(const GameState &current_state);
@@ -54,30 +75,182 @@ class TzaarGame {
   int turn_move_count();
   void set_turn_move_count(int turn_move_count);
 
+  /// Changes the heuristic evaluation coefficients.
+  void set_coefficients(int tzaar_coefficient, int tzarra_coefficient,
+      int tott_coefficient, int stack_coefficient);
+
+  /// Changes how the search threads share the work.
+  void set_parallel_search(
+      wartzaar::types::parallelsearch::ParallelSearch parallel_search);
+
+  /// Turns off the progress and results the search writes to the console,
+  /// or turns them back on.
+  void set_quiet(bool quiet);
+
+  /// Turns the time limit of each move on or off. Without it, the search is
+  /// limited only by depth and by the node limit.
+  void set_timed(bool timed);
+
+  /// Limits each search to the given number of nodes of the main thread, or
+  /// to none if zero.
+  void set_node_limit(uint64_t node_limit);
+
+  /// Returns the number of nodes visited by the last search for a move,
+  /// including quiescence nodes, or zero if the move was planned.
+  uint64_t search_nodes() const;
+
+  /// Turns pondering on the opponent's turn on or off.
+  void set_ponder(bool ponder);
+
  private:
   void Init();
 
-  /// Executes the recursive minimax search on the game state tree.
-  float Minimax(GameState &state, int depth, float alpha, float beta,
-      wartzaar::types::color::Color color, bool capture_only);
+  /// Makes the given move on the current state, and returns the message that
+  /// sends it.
+  wartzaar::messages::MoveMessage PlayMove(const Move &move);
 
-  /// Returns the number of possible game states based on the current state.
-  int CountSuccessors(const GameState &state,
-      wartzaar::types::color::Color color, bool capture_only) const;
+  /// Returns the best move stored in the transposition table for the current
+  /// state, or a null move if there is none that can be made there.
+  Move StoredMove() const;
 
-  /// Finds the next possible game states based on the current state.
-  std::vector<GameState> FindSuccessors(const GameState &state,
-      wartzaar::types::color::Color color, bool capture_only) const;
+  /// Searches the current state with every thread, from the given root moves,
+  /// until the main thread is done.
+  void Search(MoveList root_moves);
+
+  /// Starts searching the opponent's turn in the background, if pondering is
+  /// on and it is the opponent's move.
+  void StartPondering();
+
+  /// Stops the background search, if one is running. Returns true if it was.
+  bool StopPondering();
+
+  /// Prepares a thread to search the current state, starting from the given
+  /// root moves.
+  void StartThread(SearchThread &thread, const MoveList &root_moves);
+
+  /// Runs the depth-first iterative deepening (DFID) search of a thread,
+  /// until it reaches the depth limit or the search is stopped.
+  void IterativeDeepening(SearchThread &thread);
+
+  /// Returns the thread whose result is played: the main thread, unless a
+  /// helper has completed a deeper iteration.
+  const SearchThread& BestThread() const;
+
+  /// Runs a Young Brothers Wait helper thread, which joins split points made
+  /// by the other threads until the search is stopped.
+  void HelpSearch(SearchThread &thread);
+
+  /// Returns true if the thread should search the children of a node in
+  /// parallel, from the next one on.
+  bool CanSplit(const SearchThread &thread, int depth,
+      const Move *next, const Move *end) const;
+
+  /// Searches the children from first up to last of the thread's current node
+  /// together with any idle threads, narrowing alpha or beta and setting
+  /// best_move as the children are searched.
+  void Split(SearchThread &thread, const Move *first, const Move *last,
+      int depth, float &alpha, float &beta, Move &best_move);
+
+  /// Finds a split point of another thread with work left, and joins it. If
+  /// ancestor is not null, only split points below it are joined. Returns
+  /// null if there is none.
+  SplitPoint* StealSplitPoint(SearchThread &thread,
+      const SplitPoint *ancestor);
+
+  /// Searches children of a split point the thread has joined, from the
+  /// split point's state, and leaves it.
+  void HelpAtSplitPoint(SearchThread &thread, SplitPoint &split_point);
+
+  /// Searches children of a split point until there are none left or a
+  /// cutoff is found.
+  void WorkAtSplitPoint(SearchThread &thread, SplitPoint &split_point);
+
+  /// Searches the root to the thread's current iteration depth, through an
+  /// aspiration window around the score of an earlier iteration.
+  void SearchRoot(SearchThread &thread);
+
+  /// Executes the recursive minimax search on the game state tree, making and
+  /// taking back moves on the thread's state.
+  float Minimax(SearchThread &thread, int depth, float alpha, float beta);
+
+  /// Executes the capture-only quiescence search at the leaves of the minimax
+  /// search, down to the given depth.
+  float Quiesce(SearchThread &thread, int depth, float alpha, float beta);
+
+  /// Returns true once the search should stop, because the time is up or
+  /// the main thread has finished.
+  bool Stopped();
+
+  /// Returns true if the thread should stop searching its current node,
+  /// because the search has stopped or a split point above it was cut off.
+  bool Aborted(SearchThread &thread);
+
+  /// Returns the most the evaluation can change by when the stack on the
+  /// given cell is captured, unless the capture ends the game some other way.
+  float CaptureGain(const GameState &state, int to_cell) const;
+
+  /// Returns the most the evaluation can change by through the second capture
+  /// of the turn whose first move is made from the given state, or float_max_
+  /// if the second capture might end the game.
+  float SecondCaptureGain(const GameState &state) const;
+
+  /// Returns true if the given capture might leave a player with no captures,
+  /// which ends the game.
+  bool CaptureCanEndGame(const GameState &state, const Move &move) const;
+
+  /// Sorts the successors of a node at the given ply, most promising first.
+  void OrderMoves(SearchThread &thread, MoveList &successors, int ply,
+      const Move &hash_move);
+
+  /// Returns the ordering score of a capture of the stack in the given cell.
+  int CaptureScore(const GameState &state, int to_cell) const;
+
+  /// Updates the killer moves and history scores for a move that caused a
+  /// cutoff at the given ply and depth.
+  void RecordCutoff(SearchThread &thread, const Move &move, int ply,
+      int depth);
+
+  /// Halves all history scores of a thread.
+  void AgeHistory(SearchThread &thread);
+
+  /// Sorts the root moves by the scores of the last iteration, best first,
+  /// with the principal variation move in front.
+  void SortRootMoves(SearchThread &thread);
+
+  /// Records that the given move is the best found so far at the given ply,
+  /// followed by the best line from the ply below.
+  void UpdatePv(SearchThread &thread, int ply, const Move &move);
 
   ///
-  float EvaluateHeuristic(GameState state, wartzaar::types::color::Color color,
-      bool capture_only);
+  float EvaluateHeuristic(const GameState &state,
+      wartzaar::types::color::Color color, bool capture_only) const;
+
+  /// Fills in the evaluation tables from the coefficients.
+  void BuildEvaluationTables();
+
+  /// Move ordering scores of each stage. History scores are kept below
+  /// kKillerScore.
+  static const int kPvMoveScore   = 1 << 30;
+  static const int kHashMoveScore = 1 << 29;
+  static const int kCaptureScore  = 1 << 28;
+  static const int kKillerScore   = 1 << 27;
+
+  /// The largest number of pieces of one type and color.
+  static const int kMaxPieceCount = 15;
+
+  /// The largest adjusted stack height of one type and color, plus one.
+  static const int kMaxStackHeight = 30;
 
   /// Maximum float value.
   float float_max_ = (std::numeric_limits<float>::max)();
 
-  /// Pre-computed values for ln(n - 0.9), from 1 through 15.
-  float ln_[16];
+  /// The material value of each piece count, indexed by piece type - 1 and
+  /// count.
+  float material_value_[3][kMaxPieceCount + 1];
+
+  /// The stack value of each adjusted stack height, indexed by piece type - 1
+  /// and height.
+  float stack_value_[3][kMaxStackHeight];
 
   /// The duration of each turn, in seconds.
   /// This is used to limit the time spent trying to find the best next move.
@@ -86,28 +259,72 @@ class TzaarGame {
   /// The total number of plies to search down the state tree.
   int max_depth_;
 
-  /// The depth of the current iteration of the DFID/minimax search.
-  int local_depth_;
-
   /// The number of states to search at each ply.
   int beam_size_;
 
+  /// The number of plies of captures searched past the depth limit.
+  int qsearch_depth_;
+
   int tzaar_coefficient_;
   int tzarra_coefficient_;
   int tott_coefficient_;
   int stack_coefficient_;
 
-  std::vector<wartzaar::types::direction::Direction> directions_;
   GameState current_state_;
-  GameState best_move_;
+
+  /// The search threads. Thread 0 is the main thread; the others are helpers
+  /// that share the search with it, as set by parallel_search_. Each thread
+  /// keeps its move ordering tables from one search to the next.
+  std::vector<SearchThread> threads_;
+
+  /// How the search threads share the work.
+  wartzaar::types::parallelsearch::ParallelSearch parallel_search_;
+
+  /// The split points of each thread that other threads may join, and the
+  /// number of Young Brothers Wait helpers looking for work.
+  std::vector<SplitQueue> split_queues_;
+  std::atomic<int> idle_threads_;
 
   wartzaar::types::color::Color player_color_;
   wartzaar::types::playernumber::PlayerNumber player_number_;
   int turn_count_;
   int turn_move_count_;
-  clock_t turn_move_timeout_;
 
-//  std::map<std::string, float> memoized_states_;
+  /// Times the current search, and decides when it must end.
+  TimeManager time_manager_;
+
+  /// Set when the search must stop, so that every thread stops.
+  std::atomic<bool> stop_;
+
+  /// Whether the search writes nothing to the console.
+  bool quiet_;
+
+  /// Whether each search is limited by time, and the number of nodes of the
+  /// main thread it is limited to (zero if none).
+  bool timed_;
+  uint64_t node_limit_;
+
+  /// The number of nodes visited by the last search for a move.
+  uint64_t search_nodes_;
+
+  /// Whether to ponder, and the thread searching the opponent's turn while
+  /// we wait for their moves. The thread is not joinable when not pondering.
+  bool ponder_;
+  bool pondering_;
+  std::thread ponder_thread_;
+
+  /// The second move of the turn, planned by the search for the first move,
+  /// and the key of the state it was planned for. The planned move is null
+  /// when there is no plan.
+  Move planned_move_;
+  uint64_t planned_hash_;
+
+  /// When the time of the turn whose first move was last searched runs out,
+  /// or the maximum time point if that search did not plan the turn.
+  Clock::time_point turn_deadline_;
+
+  /// Search results cached by state, shared by all iterations and all moves.
+  TranspositionTable transposition_table_;
 };
 
 } // namespace wartzaar
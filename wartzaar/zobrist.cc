@@ -0,0 +1,65 @@
+#include "wartzaar/zobrist.h"
+
+namespace wartzaar {
+
+uint64_t Zobrist::piece_keys_[GameBoard::kNumCells][2][3];
+uint64_t Zobrist::height_keys_[GameBoard::kNumCells][Zobrist::kMaxStackHeight + 1];
+uint64_t Zobrist::black_to_move_key_;
+uint64_t Zobrist::second_move_key_;
+
+///-----------------------------------------------------------------------------
+/// ZobristKeys fills in the Zobrist keys when the program starts.
+///-----------------------------------------------------------------------------
+class ZobristKeys {
+ public:
+  ZobristKeys();
+
+ private:
+  /// Returns the next number of a SplitMix64 sequence.
+  uint64_t Next();
+
+  uint64_t seed_;
+};
+
+ZobristKeys::ZobristKeys()
+    : seed_(0x5a5a1ee7c0ffee11ULL) {
+  for (int cell = 0; cell < GameBoard::kNumCells; ++cell)
+    for (int color = 0; color < 2; ++color)
+      for (int type = 0; type < 3; ++type)
+        Zobrist::piece_keys_[cell][color][type] = Next();
+
+  // A stack of height zero is an empty cell, which doesn't contribute to the
+  // hash.
+  for (int cell = 0; cell < GameBoard::kNumCells; ++cell) {
+    Zobrist::height_keys_[cell][0] = 0;
+    for (int height = 1; height <= Zobrist::kMaxStackHeight; ++height)
+      Zobrist::height_keys_[cell][height] = Next();
+  }
+
+  Zobrist::black_to_move_key_ = Next();
+  Zobrist::second_move_key_ = Next();
+}
+
+uint64_t ZobristKeys::Next() {
+  uint64_t z = (seed_ += 0x9e3779b97f4a7c15ULL);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+namespace {
+
+const ZobristKeys kZobristKeys;
+
+} // namespace
+
+uint64_t Zobrist::HashBoard(const GameBoard &board) {
+  uint64_t hash = 0;
+
+  for (int cell = 0; cell < GameBoard::kNumCells; ++cell)
+    hash ^= StackKey(board, cell);
+
+  return hash;
+}
+
+} // namespace wartzaar
@@ -0,0 +1,80 @@
+#ifndef WARTZAAR_ZOBRIST_H_
+#define WARTZAAR_ZOBRIST_H_
+
+#include <stdint.h>
+
+#include "wartzaar/game_board.h"
+#include "wartzaar/types/color.h"
+#include "wartzaar/types/piece_type.h"
+
+namespace wartzaar {
+
+///-----------------------------------------------------------------------------
+/// Zobrist holds the random keys used to hash game states.
+///
+/// The key of a stack is the XOR of a key for its cell, color and top piece
+/// type and a key for its cell and height. The key of a state is the XOR of the
+/// keys of all its stacks, plus BlackToMoveKey when black is to move and
+/// SecondMoveKey on the second move of a turn. The keys are generated from a
+/// fixed seed when the program starts, so hashes are the same in every run.
+///-----------------------------------------------------------------------------
+class Zobrist {
+ public:
+  /// The tallest possible stack: every piece of one color.
+  static const int kMaxStackHeight = 30;
+
+  /// Returns the key of a stack of the given color, type and height.
+  static uint64_t StackKey(int cell, wartzaar::types::color::Color color,
+      wartzaar::types::piecetype::PieceType type, int stack_height);
+
+  /// Returns the key of the stack in the given cell of the board, or zero if
+  /// the cell is empty.
+  static uint64_t StackKey(const GameBoard &board, int cell);
+
+  /// Returns the key that is toggled when black is to move.
+  static uint64_t BlackToMoveKey();
+
+  /// Returns the key that is toggled on the second move of a turn.
+  static uint64_t SecondMoveKey();
+
+  /// Computes the hash of the stacks on the given board from scratch.
+  static uint64_t HashBoard(const GameBoard &board);
+
+ private:
+  friend class ZobristKeys;
+
+  /// Keys by cell, color - 1 and type - 1.
+  static uint64_t piece_keys_[GameBoard::kNumCells][2][3];
+
+  /// Keys by cell and stack height.
+  static uint64_t height_keys_[GameBoard::kNumCells][kMaxStackHeight + 1];
+
+  static uint64_t black_to_move_key_;
+  static uint64_t second_move_key_;
+};
+
+inline uint64_t Zobrist::StackKey(int cell, wartzaar::types::color::Color color,
+    wartzaar::types::piecetype::PieceType type, int stack_height) {
+  return piece_keys_[cell][color - 1][type - 1]
+       ^ height_keys_[cell][stack_height];
+}
+
+inline uint64_t Zobrist::StackKey(const GameBoard &board, int cell) {
+  if (!board.IsOccupied(cell))
+    return 0;
+
+  return StackKey(cell, board.ColorAt(cell), board.TypeAt(cell),
+      board.StackHeightAt(cell));
+}
+
+inline uint64_t Zobrist::BlackToMoveKey() {
+  return black_to_move_key_;
+}
+
+inline uint64_t Zobrist::SecondMoveKey() {
+  return second_move_key_;
+}
+
+} // namespace wartzaar
+
+#endif // WARTZAAR_ZOBRIST_H_